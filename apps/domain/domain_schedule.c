@@ -0,0 +1,25 @@
+/*
+ * Copyright 2017, Data61
+ * Commonwealth Scientific and Industrial Research Organisation (CSIRO)
+ * ABN 41 687 119 230.
+ *
+ * This software may be distributed and modified according to the terms of
+ * the BSD 2-Clause license. Note that NO WARRANTY is provided.
+ * See "LICENSE_BSD2.txt" for details.
+ *
+ * @TAG(DATA61_BSD)
+ */
+
+#include <config.h>
+#include <object/structures.h>
+#include <model/statedata.h>
+
+/* Domain schedule for the domain benchmark, which alternates between the domain the
+ * benchmark runs in and the domain it places the other thread in. Lengths are in
+ * timer ticks, or milliseconds on the RT kernel. */
+const dschedule_t ksDomSchedule[] = {
+    { .domain = 0, .length = 1 },
+    { .domain = 1, .length = 1 },
+};
+
+const word_t ksDomScheduleLength = sizeof(ksDomSchedule) / sizeof(dschedule_t);
@@ -0,0 +1,257 @@
+/*
+ * Copyright 2017, Data61
+ * Commonwealth Scientific and Industrial Research Organisation (CSIRO)
+ * ABN 41 687 119 230.
+ *
+ * This software may be distributed and modified according to the terms of
+ * the BSD 2-Clause license. Note that NO WARRANTY is provided.
+ * See "LICENSE_BSD2.txt" for details.
+ *
+ * @TAG(DATA61_BSD)
+ */
+
+#include <autoconf.h>
+#include <stdio.h>
+
+#include <sel4/sel4.h>
+#include <sel4bench/arch/sel4bench.h>
+
+#include <benchmark.h>
+#include <domain.h>
+
+#if CONFIG_NUM_DOMAINS < 2
+#error "The domain benchmark requires a kernel with more than one domain"
+#endif
+
+#define N_LATENCY_ARGS 3
+#define N_WALK_ARGS 4
+/* the benchmark runs in the first domain, the other thread in the second */
+#define OTHER_DOMAIN 1
+#define DOMAIN_PRIO (seL4_MaxPrio - 1)
+
+void
+abort(void)
+{
+    benchmark_finished(EXIT_FAILURE);
+}
+
+size_t __arch_write(char *data, int count)
+{
+    return benchmark_write(data, count);
+}
+
+/* runs in domain 0 until it is switched out */
+static void
+last_ccnt_fn(int argc, char **argv)
+{
+    assert(argc == N_LATENCY_ARGS);
+    volatile ccnt_t *last = (volatile ccnt_t *) atol(argv[0]);
+
+    while (1) {
+        SEL4BENCH_READ_CCNT(*last);
+    }
+}
+
+/* runs in domain 1, and records how long since domain 0 last ran each time it
+ * is switched to */
+static void
+first_ccnt_fn(int argc, char **argv)
+{
+    assert(argc == N_LATENCY_ARGS);
+    volatile ccnt_t *last = (volatile ccnt_t *) atol(argv[0]);
+    ccnt_t *results = (ccnt_t *) atol(argv[1]);
+    seL4_CPtr done_ep = (seL4_CPtr) atol(argv[2]);
+    ccnt_t prev, now;
+
+    SEL4BENCH_READ_CCNT(prev);
+    for (int i = 0; i < N_RUNS;) {
+        SEL4BENCH_READ_CCNT(now);
+        if (now - prev > DOMAIN_GAP_CYCLES) {
+            results[i] = now - *last;
+            i++;
+        }
+        prev = now;
+    }
+
+    seL4_Send(done_ep, seL4_MessageInfo_new(0, 0, 0, 0));
+    seL4_Wait(done_ep, NULL);
+}
+
+/* walks the working set, and reports whether the other domain ran during the walk */
+static ccnt_t
+walk(volatile seL4_Word *working_set, size_t size, bool *switched)
+{
+    ccnt_t start, prev, now;
+
+    *switched = false;
+    SEL4BENCH_READ_CCNT(start);
+    prev = start;
+    for (size_t i = 0; i < size / sizeof(seL4_Word); i += DOMAIN_WALK_STRIDE / sizeof(seL4_Word)) {
+        working_set[i]++;
+        if ((i + DOMAIN_WALK_STRIDE / sizeof(seL4_Word)) % (DOMAIN_WALK_CHECK / sizeof(seL4_Word)) == 0) {
+            SEL4BENCH_READ_CCNT(now);
+            if (now - prev > DOMAIN_GAP_CYCLES) {
+                *switched = true;
+            }
+            prev = now;
+        }
+    }
+    SEL4BENCH_READ_CCNT(now);
+
+    return now - start;
+}
+
+/* runs in domain 0. With its working set warm, it spins until the other domain
+ * has run, then walks the working set twice. Both domains walk working sets of
+ * the same size. Samples where the other domain ran during either walk are
+ * discarded and taken again. */
+static void
+victim_fn(int argc, char **argv)
+{
+    assert(argc == N_WALK_ARGS);
+    volatile seL4_Word *working_set = (volatile seL4_Word *) atol(argv[0]);
+    domain_results_t *results = (domain_results_t *) atol(argv[1]);
+    seL4_CPtr done_ep = (seL4_CPtr) atol(argv[2]);
+    int s = atol(argv[3]);
+    size_t size = domain_working_set_sizes[s] * 1024;
+    ccnt_t prev, now, cold, warm;
+    bool cold_switched, warm_switched;
+
+    for (int i = 0; i < N_RUNS;) {
+        walk(working_set, size, &cold_switched);
+
+        SEL4BENCH_READ_CCNT(prev);
+        do {
+            now = prev;
+            SEL4BENCH_READ_CCNT(prev);
+        } while (prev - now < DOMAIN_GAP_CYCLES);
+
+        cold = walk(working_set, size, &cold_switched);
+        warm = walk(working_set, size, &warm_switched);
+        if (!cold_switched && !warm_switched) {
+            results->cold_walk[s][i] = cold;
+            results->warm_walk[s][i] = warm;
+            i++;
+        }
+    }
+
+    seL4_Send(done_ep, seL4_MessageInfo_new(0, 0, 0, 0));
+    seL4_Wait(done_ep, NULL);
+}
+
+/* runs in domain 1 and replaces the cache contents with its own working set */
+static void
+polluter_fn(int argc, char **argv)
+{
+    assert(argc == N_WALK_ARGS);
+    volatile seL4_Word *working_set = (volatile seL4_Word *) atol(argv[0]);
+    size_t size = domain_working_set_sizes[atol(argv[3])] * 1024;
+    bool switched;
+
+    while (1) {
+        walk(working_set, size, &switched);
+    }
+}
+
+static void
+set_domain(env_t *env, sel4utils_thread_t *thread, seL4_Word domain)
+{
+    int error = seL4_DomainSet_Set(env->args->domain, domain, thread->tcb.cptr);
+    ZF_LOGF_IF(error, "Failed to set domain");
+}
+
+static void
+run_pair(env_t *env, seL4_CPtr done_ep, void *fn, void *other_fn, char **argv, char **other_argv,
+         int argc, char *name)
+{
+    sel4utils_thread_t thread, other;
+    UNUSED int error;
+
+    benchmark_configure_thread(env, done_ep, DOMAIN_PRIO, name, &thread);
+    benchmark_configure_thread(env, done_ep, DOMAIN_PRIO, name, &other);
+    set_domain(env, &other, OTHER_DOMAIN);
+
+    error = sel4utils_start_thread(&thread, (sel4utils_thread_entry_fn) fn, (void *) (seL4_Word) argc,
+                                   (void *) argv, true);
+    ZF_LOGF_IF(error, "Failed to start %s", name);
+    error = sel4utils_start_thread(&other, (sel4utils_thread_entry_fn) other_fn, (void *) (seL4_Word) argc,
+                                   (void *) other_argv, true);
+    ZF_LOGF_IF(error, "Failed to start %s", name);
+
+    benchmark_wait_children(done_ep, name, 1);
+
+    seL4_TCB_Suspend(thread.tcb.cptr);
+    seL4_TCB_Suspend(other.tcb.cptr);
+}
+
+static void
+measure_overhead(ccnt_t results[N_RUNS])
+{
+    ccnt_t start, end;
+    for (int i = 0; i < N_RUNS; i++) {
+        SEL4BENCH_READ_CCNT(start);
+        SEL4BENCH_READ_CCNT(end);
+        results[i] = end - start;
+    }
+}
+
+int
+main(int argc, char **argv)
+{
+    env_t *env;
+    domain_results_t *results;
+    vka_object_t done_ep = {0};
+    volatile ccnt_t last = 0;
+    char latency_strings[N_LATENCY_ARGS][WORD_STRING_SIZE];
+    char *latency_argv[N_LATENCY_ARGS];
+    char victim_strings[N_WALK_ARGS][WORD_STRING_SIZE];
+    char *victim_argv[N_WALK_ARGS];
+    char polluter_strings[N_WALK_ARGS][WORD_STRING_SIZE];
+    char *polluter_argv[N_WALK_ARGS];
+    UNUSED int error;
+
+    /* a pair of threads for the switch latency, and for each working set size */
+    static size_t object_freq[seL4_ObjectTypeCount] = {
+        [seL4_TCBObject] = 2 + 2 * N_DOMAIN_WORKING_SETS,
+        [seL4_EndpointObject] = 1,
+#ifdef CONFIG_KERNEL_RT
+        [seL4_SchedContextObject] = 2 + 2 * N_DOMAIN_WORKING_SETS,
+        [seL4_ReplyObject] = 2 + 2 * N_DOMAIN_WORKING_SETS,
+#endif
+    };
+
+    env = benchmark_get_env(argc, argv, sizeof(domain_results_t), object_freq);
+    results = (domain_results_t *) env->results;
+
+    sel4bench_init();
+
+    error = vka_alloc_endpoint(&env->slab_vka, &done_ep);
+    ZF_LOGF_IF(error, "Failed to allocate endpoint");
+
+    measure_overhead(results->ccnt_overhead);
+
+    /* both threads share the argument list, only the one in domain 1 records */
+    sel4utils_create_word_args(latency_strings, latency_argv, N_LATENCY_ARGS, (seL4_Word) &last,
+                               (seL4_Word) results->switch_latency, done_ep.cptr);
+    run_pair(env, done_ep.cptr, last_ccnt_fn, first_ccnt_fn, latency_argv, latency_argv,
+             N_LATENCY_ARGS, "domain switch");
+
+    void *victim_set = vspace_new_pages(&env->vspace, seL4_AllRights,
+                                        DOMAIN_MAX_WORKING_SET / BIT(seL4_PageBits), seL4_PageBits);
+    void *polluter_set = vspace_new_pages(&env->vspace, seL4_AllRights,
+                                          DOMAIN_MAX_WORKING_SET / BIT(seL4_PageBits), seL4_PageBits);
+    ZF_LOGF_IF(victim_set == NULL || polluter_set == NULL, "Failed to allocate working sets");
+
+    for (int s = 0; s < N_DOMAIN_WORKING_SETS; s++) {
+        sel4utils_create_word_args(victim_strings, victim_argv, N_WALK_ARGS, (seL4_Word) victim_set,
+                                   (seL4_Word) results, done_ep.cptr, s);
+        sel4utils_create_word_args(polluter_strings, polluter_argv, N_WALK_ARGS, (seL4_Word) polluter_set,
+                                   (seL4_Word) results, done_ep.cptr, s);
+        run_pair(env, done_ep.cptr, victim_fn, polluter_fn, victim_argv, polluter_argv, N_WALK_ARGS,
+                 "working set");
+    }
+
+    /* done -> results are stored in shared memory so we can now return */
+    benchmark_finished(EXIT_SUCCESS);
+    return 0;
+}
@@ -0,0 +1,203 @@
+/*
+ * Copyright 2017, Data61
+ * Commonwealth Scientific and Industrial Research Organisation (CSIRO)
+ * ABN 41 687 119 230.
+ *
+ * This software may be distributed and modified according to the terms of
+ * the BSD 2-Clause license. Note that NO WARRANTY is provided.
+ * See "LICENSE_BSD2.txt" for details.
+ *
+ * @TAG(DATA61_BSD)
+ */
+
+#include <autoconf.h>
+#include <stdio.h>
+
+#include <sel4/sel4.h>
+#include <sel4bench/arch/sel4bench.h>
+
+#include <benchmark.h>
+#include <eventloop.h>
+
+#define N_SERVER_ARGS 2
+#define N_CLIENT_ARGS 5
+/* the server runs above the client, so handles each event as soon as it is sent */
+#define SERVER_PRIO (seL4_MaxPrio - 1)
+#define CLIENT_PRIO (seL4_MaxPrio - 2)
+/* badges of the client's caps, so the server can tell which woke it */
+#define IPC_BADGE BIT(0)
+#define SIGNAL_BADGE BIT(1)
+
+/* cycle count of the server waking for the most recent event */
+static volatile ccnt_t server_start;
+
+void
+abort(void)
+{
+    benchmark_finished(EXIT_FAILURE);
+}
+
+size_t __arch_write(char *data, int count)
+{
+    return benchmark_write(data, count);
+}
+
+/* receives on an endpoint with a bound notification, replying to IPCs and
+ * waiting again straight away after signals */
+static void
+server_fn(int argc, char **argv)
+{
+    assert(argc == N_SERVER_ARGS);
+    seL4_CPtr ep = (seL4_CPtr) atol(argv[0]);
+    seL4_CPtr reply = (seL4_CPtr) atol(argv[1]);
+    seL4_Word badge;
+
+    api_recv(ep, &badge, reply);
+    while (1) {
+        SEL4BENCH_READ_CCNT(server_start);
+        if (badge & SIGNAL_BADGE) {
+            api_recv(ep, &badge, reply);
+        } else {
+            api_reply_recv(ep, seL4_MessageInfo_new(0, 0, 0, 0), &badge, reply);
+        }
+    }
+}
+
+static int
+next_event(int mix, int i, uint16_t *lfsr)
+{
+    switch (mix) {
+    case MIX_IPC:
+        return EVENT_IPC;
+    case MIX_SIGNAL:
+        return EVENT_SIGNAL;
+    case MIX_ALTERNATE:
+        return i % 2 == 0 ? EVENT_IPC : EVENT_SIGNAL;
+    default:
+        /* 16 bit Fibonacci LFSR, so every run sends the same sequence */
+        *lfsr = (*lfsr >> 1) | ((*lfsr ^ (*lfsr >> 2) ^ (*lfsr >> 3) ^ (*lfsr >> 5)) << 15);
+        return (*lfsr & 1) ? EVENT_SIGNAL : EVENT_IPC;
+    }
+}
+
+/* sends events in the order of the mix until each kind it sends has been measured
+ * N_RUNS times */
+static void
+client_fn(int argc, char **argv)
+{
+    assert(argc == N_CLIENT_ARGS);
+    seL4_CPtr ep = (seL4_CPtr) atol(argv[0]);
+    seL4_CPtr ntfn = (seL4_CPtr) atol(argv[1]);
+    int mix = atol(argv[2]);
+    eventloop_results_t *results = (eventloop_results_t *) atol(argv[3]);
+    seL4_CPtr done_ep = (seL4_CPtr) atol(argv[4]);
+    int n[N_EVENT_TYPES] = {0};
+    uint16_t lfsr = 0xACE1u;
+
+    for (int i = 0; (eventloop_mix_has(mix, EVENT_IPC) && n[EVENT_IPC] < N_RUNS) ||
+            (eventloop_mix_has(mix, EVENT_SIGNAL) && n[EVENT_SIGNAL] < N_RUNS); i++) {
+        int event = next_event(mix, i, &lfsr);
+        ccnt_t start, end;
+
+        SEL4BENCH_READ_CCNT(start);
+        if (event == EVENT_SIGNAL) {
+            seL4_Signal(ntfn);
+        } else {
+            seL4_Call(ep, seL4_MessageInfo_new(0, 0, 0, 0));
+        }
+        SEL4BENCH_READ_CCNT(end);
+
+        if (n[event] < N_RUNS) {
+            results->arrival[mix][event][n[event]] = server_start - start;
+            results->handled[mix][event][n[event]] = end - start;
+            n[event]++;
+        }
+    }
+
+    seL4_Send(done_ep, seL4_MessageInfo_new(0, 0, 0, 0));
+    seL4_Wait(done_ep, NULL);
+}
+
+static void
+measure_overhead(ccnt_t results[N_RUNS])
+{
+    ccnt_t start, end;
+    for (int i = 0; i < N_RUNS; i++) {
+        SEL4BENCH_READ_CCNT(start);
+        SEL4BENCH_READ_CCNT(end);
+        results[i] = end - start;
+    }
+}
+
+int
+main(int argc, char **argv)
+{
+    env_t *env;
+    eventloop_results_t *results;
+    vka_object_t done_ep = {0};
+    vka_object_t ep = {0};
+    vka_object_t ntfn = {0};
+    sel4utils_thread_t server, client;
+    char server_strings[N_SERVER_ARGS][WORD_STRING_SIZE];
+    char *server_argv[N_SERVER_ARGS];
+    char client_strings[N_CLIENT_ARGS][WORD_STRING_SIZE];
+    char *client_argv[N_CLIENT_ARGS];
+    UNUSED int error;
+
+    static size_t object_freq[seL4_ObjectTypeCount] = {
+        [seL4_TCBObject] = 2,
+        [seL4_EndpointObject] = 2,
+        [seL4_NotificationObject] = 1,
+#ifdef CONFIG_KERNEL_RT
+        [seL4_SchedContextObject] = 2,
+        [seL4_ReplyObject] = 2,
+#endif
+    };
+
+    env = benchmark_get_env(argc, argv, sizeof(eventloop_results_t), object_freq);
+    results = (eventloop_results_t *) env->results;
+
+    sel4bench_init();
+
+    error = vka_alloc_endpoint(&env->slab_vka, &done_ep);
+    ZF_LOGF_IF(error, "Failed to allocate endpoint");
+    error = vka_alloc_endpoint(&env->slab_vka, &ep);
+    ZF_LOGF_IF(error, "Failed to allocate endpoint");
+    error = vka_alloc_notification(&env->slab_vka, &ntfn);
+    ZF_LOGF_IF(error, "Failed to allocate notification");
+
+    measure_overhead(results->ccnt_overhead);
+
+    benchmark_configure_thread(env, done_ep.cptr, SERVER_PRIO, "server", &server);
+    benchmark_configure_thread(env, done_ep.cptr, CLIENT_PRIO, "client", &client);
+
+    error = seL4_TCB_BindNotification(server.tcb.cptr, ntfn.cptr);
+    ZF_LOGF_IF(error, "Failed to bind notification");
+
+    sel4utils_create_word_args(server_strings, server_argv, N_SERVER_ARGS, ep.cptr, server.reply.cptr);
+    error = sel4utils_start_thread(&server, (sel4utils_thread_entry_fn) server_fn,
+                                   (void *) N_SERVER_ARGS, (void *) server_argv, true);
+    ZF_LOGF_IF(error, "Failed to start server");
+
+    seL4_CPtr badged_ep = benchmark_mint_badged_cap(env, ep.cptr, IPC_BADGE);
+    seL4_CPtr badged_ntfn = benchmark_mint_badged_cap(env, ntfn.cptr, SIGNAL_BADGE);
+
+    for (int mix = 0; mix < N_EVENTLOOP_MIXES; mix++) {
+        sel4utils_create_word_args(client_strings, client_argv, N_CLIENT_ARGS, badged_ep, badged_ntfn,
+                                   mix, (seL4_Word) results, done_ep.cptr);
+        error = sel4utils_start_thread(&client, (sel4utils_thread_entry_fn) client_fn,
+                                       (void *) N_CLIENT_ARGS, (void *) client_argv, true);
+        ZF_LOGF_IF(error, "Failed to start client");
+
+        benchmark_wait_children(done_ep.cptr, "client", 1);
+
+        error = seL4_TCB_Suspend(client.tcb.cptr);
+        ZF_LOGF_IF(error, "Failed to suspend client");
+    }
+
+    seL4_TCB_Suspend(server.tcb.cptr);
+
+    /* done -> results are stored in shared memory so we can now return */
+    benchmark_finished(EXIT_SUCCESS);
+    return 0;
+}
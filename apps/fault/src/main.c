@@ -25,6 +25,8 @@
 
 #define N_FAULTER_ARGS 3
 #define N_HANDLER_ARGS 5
+#define N_TIMEOUT_FAULTER_ARGS 4
+#define N_TIMEOUT_HANDLER_ARGS 7
 
 static char faulter_args[N_FAULTER_ARGS][WORD_STRING_SIZE];
 static char *faulter_argv[N_FAULTER_ARGS];
@@ -276,6 +278,117 @@ run_fault_benchmark(env_t *env, fault_results_t *results)
     run_benchmark(measure_fault_roundtrip_fn, measure_fault_roundtrip_handler_fn, done_ep.cptr);
 }
 
+#ifdef CONFIG_KERNEL_RT
+/* spins until its budget expires, which raises a timeout fault. The handler
+ * refills the budget and sets reply_start just before replying, which is how
+ * the first loop after resuming tells it has been replied to. */
+static void
+measure_timeout_fault_fn(int argc, char **argv)
+{
+    assert(argc == N_TIMEOUT_FAULTER_ARGS);
+    volatile ccnt_t *start = (volatile ccnt_t *) atol(argv[0]);
+    volatile ccnt_t *reply_start = (volatile ccnt_t *) atol(argv[1]);
+    fault_results_t *results = (fault_results_t *) atol(argv[2]);
+    seL4_CPtr done_ep = atol(argv[3]);
+    ccnt_t end;
+
+    for (int i = 0; i < N_RUNS + 1;) {
+        SEL4BENCH_READ_CCNT(*start);
+        if (*reply_start != 0) {
+            SEL4BENCH_READ_CCNT(end);
+            results->timeout_fault_reply[i] = end - *reply_start;
+            *reply_start = 0;
+            i++;
+        }
+    }
+    seL4_Signal(done_ep);
+}
+
+static void
+measure_timeout_fault_handler_fn(int argc, char **argv)
+{
+    assert(argc == N_TIMEOUT_HANDLER_ARGS);
+    seL4_CPtr ep = atol(argv[0]);
+    volatile ccnt_t *start = (volatile ccnt_t *) atol(argv[1]);
+    volatile ccnt_t *reply_start = (volatile ccnt_t *) atol(argv[2]);
+    fault_results_t *results = (fault_results_t *) atol(argv[3]);
+    seL4_CPtr reply = atol(argv[4]);
+    seL4_CPtr sched_ctrl = atol(argv[5]);
+    seL4_CPtr sc = atol(argv[6]);
+    ccnt_t end;
+
+    /* wait for first fault */
+    seL4_MessageInfo_t info = api_recv(ep, NULL, reply);
+    for (int i = 0; i < N_RUNS + 1; i++) {
+        SEL4BENCH_READ_CCNT(end);
+        results->timeout_fault[i] = end - *start;
+        ZF_LOGF_IF(seL4_MessageInfo_get_label(info) != seL4_Fault_Timeout, "Expected timeout fault");
+
+        /* refill the budget so the faulter runs as soon as it is replied to */
+        UNUSED int error = api_sched_ctrl_configure(sched_ctrl, sc, TIMEOUT_FAULT_BUDGET,
+                                                    TIMEOUT_FAULT_PERIOD, 0, 0);
+        assert(error == seL4_NoError);
+
+        SEL4BENCH_READ_CCNT(*reply_start);
+        info = api_reply_recv(ep, seL4_MessageInfo_new(0, 0, 0, 0), NULL, reply);
+    }
+}
+
+/* the timeout fault handler must be active, as a passive one would have no budget to
+ * run on, and above the faulter so it runs as soon as the fault is delivered */
+static void
+run_timeout_fault_benchmark(env_t *env, fault_results_t *results)
+{
+    sel4utils_thread_t timeout_faulter, timeout_handler;
+    char timeout_faulter_args[N_TIMEOUT_FAULTER_ARGS][WORD_STRING_SIZE];
+    char *timeout_faulter_argv[N_TIMEOUT_FAULTER_ARGS];
+    char timeout_handler_args[N_TIMEOUT_HANDLER_ARGS][WORD_STRING_SIZE];
+    char *timeout_handler_argv[N_TIMEOUT_HANDLER_ARGS];
+    volatile ccnt_t start = 0;
+    volatile ccnt_t reply_start = 0;
+    seL4_CPtr sched_ctrl = simple_get_sched_ctrl(&env->simple, 0);
+
+    vka_object_t timeout_endpoint = {0};
+    int error = vka_alloc_endpoint(&env->slab_vka, &timeout_endpoint);
+    ZF_LOGF_IF(error, "Failed to allocate timeout endpoint");
+
+    vka_object_t done_ep = {0};
+    error = vka_alloc_endpoint(&env->slab_vka, &done_ep);
+    ZF_LOGF_IF(error, "Failed to allocate done endpoint");
+
+    benchmark_configure_thread(env, done_ep.cptr, seL4_MinPrio + 1, "timeout faulter", &timeout_faulter);
+    error = api_sched_ctrl_configure(sched_ctrl, timeout_faulter.sched_context.cptr,
+                                     TIMEOUT_FAULT_BUDGET, TIMEOUT_FAULT_PERIOD, 0, 0);
+    ZF_LOGF_IF(error, "Failed to configure timeout faulter sc");
+    error = seL4_TCB_SetTimeoutEndpoint(timeout_faulter.tcb.cptr, timeout_endpoint.cptr);
+    ZF_LOGF_IF(error, "Failed to set timeout endpoint");
+
+    benchmark_configure_thread(env, done_ep.cptr, seL4_MinPrio + 2, "timeout handler", &timeout_handler);
+
+    sel4utils_create_word_args(timeout_faulter_args, timeout_faulter_argv, N_TIMEOUT_FAULTER_ARGS,
+                               (seL4_Word) &start, (seL4_Word) &reply_start, (seL4_Word) results,
+                               done_ep.cptr);
+    sel4utils_create_word_args(timeout_handler_args, timeout_handler_argv, N_TIMEOUT_HANDLER_ARGS,
+                               timeout_endpoint.cptr, (seL4_Word) &start, (seL4_Word) &reply_start,
+                               (seL4_Word) results, timeout_handler.reply.cptr, sched_ctrl,
+                               timeout_faulter.sched_context.cptr);
+
+    error = sel4utils_start_thread(&timeout_handler, (sel4utils_thread_entry_fn) measure_timeout_fault_handler_fn,
+                                   (void *) N_TIMEOUT_HANDLER_ARGS, (void *) timeout_handler_argv, true);
+    ZF_LOGF_IF(error, "Failed to start timeout handler");
+    error = sel4utils_start_thread(&timeout_faulter, (sel4utils_thread_entry_fn) measure_timeout_fault_fn,
+                                   (void *) N_TIMEOUT_FAULTER_ARGS, (void *) timeout_faulter_argv, true);
+    ZF_LOGF_IF(error, "Failed to start timeout faulter");
+
+    benchmark_wait_children(done_ep.cptr, "timeout faulter", 1);
+
+    error = seL4_TCB_Suspend(timeout_faulter.tcb.cptr);
+    ZF_LOGF_IF(error, "Failed to suspend timeout faulter");
+    error = seL4_TCB_Suspend(timeout_handler.tcb.cptr);
+    ZF_LOGF_IF(error, "Failed to suspend timeout handler");
+}
+#endif /* CONFIG_KERNEL_RT */
+
 void
 measure_overhead(fault_results_t *results)
 {
@@ -308,11 +421,14 @@ main(int argc, char **argv)
     fault_results_t *results;
 
     static size_t object_freq[seL4_ObjectTypeCount] = {
+#ifdef CONFIG_KERNEL_RT
+        [seL4_TCBObject] = 4,
+        [seL4_EndpointObject] = 4,
+        [seL4_SchedContextObject] = 4,
+        [seL4_ReplyObject] = 4,
+#else
         [seL4_TCBObject] = 2,
         [seL4_EndpointObject] = 2,
-#ifdef CONFIG_KERNEL_RT
-        [seL4_SchedContextObject] = 2,
-        [seL4_ReplyObject] = 2,
 #endif
     };
 
@@ -323,6 +439,9 @@ main(int argc, char **argv)
 
     measure_overhead(results);
     run_fault_benchmark(env, results);
+#ifdef CONFIG_KERNEL_RT
+    run_timeout_fault_benchmark(env, results);
+#endif
 
     /* done -> results are stored in shared memory so we can now return */
     benchmark_finished(EXIT_SUCCESS);
@@ -35,23 +35,55 @@
 
 #include <arch/ipc.h>
 
-#define NUM_ARGS 3
+#define NUM_ARGS 7
+/* the many address spaces client is passed the number of servers it calls as its final argument */
+#define N_SERVERS_ARG 6
 #define WARMUPS RUNS
 #define OVERHEAD_RETRIES 4
 
-#ifndef CONFIG_CYCLE_COUNT
-
-#define GENERIC_COUNTER_MASK (BIT(0))
-#undef READ_COUNTER_BEFORE
-#undef READ_COUNTER_AFTER
-#define READ_COUNTER_BEFORE(x) sel4bench_get_counters(GENERIC_COUNTER_MASK, &x);
-#define READ_COUNTER_AFTER(x) sel4bench_get_counters(GENERIC_COUNTER_MASK, &x)
+/* IPC helpers, plus the many address space servers */
+#ifdef CONFIG_APP_IPC_ADDRESS_SPACES
+#define N_HELPER_TCBS (4 + MAX_ADDRESS_SPACES)
+#else
+#define N_HELPER_TCBS 4
 #endif
 
+/* Helpers either measure the cycle counter (CCNT), or the chunk of generic counters
+ * that the driver has enabled (GENERIC). Generic helpers are passed the mask of enabled
+ * counters as their fourth argument, and record one value per generic event. */
+#define CCNT_DECLS(x) ccnt_t x
+#define CCNT_READ_BEFORE(x) READ_COUNTER_BEFORE(x)
+#define CCNT_READ_AFTER(x) READ_COUNTER_AFTER(x)
+#define CCNT_SEND(ep, x) send_result(ep, x)
+
+#define GENERIC_DECLS(x) ccnt_t x[SEL4BENCH_NUM_GENERIC_EVENTS]
+#define GENERIC_READ_BEFORE(x) sel4bench_get_counters(mask, x)
+#define GENERIC_READ_AFTER(x) sel4bench_get_counters(mask, x)
+#define GENERIC_SEND(ep, x) send_results(ep, SEL4BENCH_NUM_GENERIC_EVENTS, x)
+
+/* In cold cache mode, helpers are passed a buffer and a size as their final arguments, and
+ * touch that much of the buffer before each IPC, outside of the measured region. Touching
+ * every cache line evicts the caches, and touching every page evicts TLB entries.
+ * The stride is the smallest cache line size of the supported platforms */
+#define POLLUTION_STRIDE 32
+#define POLLUTION_DECLS(argv) \
+    UNUSED volatile char *pollution = (volatile char *) atol(argv[4]); \
+    UNUSED size_t pollution_size = atol(argv[5])
+#define POLLUTE() do { \
+    if (config_set(CONFIG_APP_IPC_COLD_CACHE)) { \
+        pollute(pollution, pollution_size); \
+    } \
+} while (0)
+
 typedef struct helper_thread {
     sel4utils_process_t process;
     seL4_CPtr ep;
     seL4_CPtr result_ep;
+    seL4_CPtr reply;
+    /* address of the pollution buffer in the helper's vspace */
+    void *pollution;
+    /* registers of the helper before it starts running, restored for each run */
+    seL4_UserContext regs;
     char *argv[NUM_ARGS];
     char argv_strings[NUM_ARGS][WORD_STRING_SIZE];
 } helper_thread_t;
@@ -71,20 +103,16 @@ static void
 timing_init(void)
 {
     sel4bench_init();
-#ifdef CONFIG_GENERIC_COUNTER
-    event_id_t event = GENERIC_EVENTS[CONFIG_GENERIC_COUNTER_ID];
-    sel4bench_set_count_event(0, event);
-    sel4bench_reset_counters();
-    sel4bench_start_counters(GENERIC_COUNTER_MASK);
-#endif
 }
 
-void
-timing_destroy(void)
+static inline void
+pollute(volatile char *buffer, size_t size)
 {
-#ifdef CONFIG_GENERIC_COUNTER
-    sel4bench_stop_counters(GENERIC_COUNTER_MASK);
-    sel4bench_destroy();
+    for (size_t i = 0; i < size; i += POLLUTION_STRIDE) {
+        buffer[i]++;
+    }
+#ifdef CONFIG_APP_IPC_COLD_CACHE_FLUSH
+    seL4_BenchmarkFlushCaches();
 #endif
 }
 
@@ -108,64 +136,42 @@ dummy_seL4_Reply(UNUSED seL4_CPtr reply, seL4_MessageInfo_t tag)
     (void)tag;
 }
 
-seL4_Word ipc_call_func(int argc, char *argv[]);
-seL4_Word ipc_call_func2(int argc, char *argv[]);
-seL4_Word ipc_call_10_func(int argc, char *argv[]);
-seL4_Word ipc_call_10_func2(int argc, char *argv[]);
-seL4_Word ipc_replyrecv_func2(int argc, char *argv[]);
-seL4_Word ipc_replyrecv_func(int argc, char *argv[]);
-seL4_Word ipc_replyrecv_10_func2(int argc, char *argv[]);
-seL4_Word ipc_replyrecv_10_func(int argc, char *argv[]);
-seL4_Word ipc_send_func(int argc, char *argv[]);
-seL4_Word ipc_recv_func(int argc, char *argv[]);
-
-static helper_func_t bench_funcs[] = {
-    ipc_call_func,
-    ipc_call_func2,
-    ipc_call_10_func,
-    ipc_call_10_func2,
-    ipc_replyrecv_func2,
-    ipc_replyrecv_func,
-    ipc_replyrecv_10_func2,
-    ipc_replyrecv_10_func,
-    ipc_send_func,
-    ipc_recv_func
-};
-
-#define IPC_CALL_FUNC(name, bench_func, send_func, call_func, send_start_end, length) \
+#define IPC_CALL_FUNC(name, counter, bench_func, send_func, call_func, send_start_end, length) \
     seL4_Word name(int argc, char *argv[]) { \
     uint32_t i; \
-    ccnt_t start UNUSED, end UNUSED; \
+    counter##_DECLS(start) UNUSED; \
+    counter##_DECLS(end) UNUSED; \
     seL4_CPtr ep = atoi(argv[0]);\
     seL4_CPtr result_ep = atoi(argv[1]);\
+    UNUSED counter_bitfield_t mask = atol(argv[3]);\
+    POLLUTION_DECLS(argv);\
     seL4_MessageInfo_t tag = seL4_MessageInfo_new(0, 0, 0, length); \
     call_func(ep, tag); \
     COMPILER_MEMORY_FENCE(); \
     for (i = 0; i < WARMUPS; i++) { \
-        READ_COUNTER_BEFORE(start); \
+        POLLUTE(); \
+        counter##_READ_BEFORE(start); \
         bench_func(ep, tag); \
-        READ_COUNTER_AFTER(end); \
+        counter##_READ_AFTER(end); \
     } \
     COMPILER_MEMORY_FENCE(); \
-    send_result(result_ep, send_start_end); \
+    counter##_SEND(result_ep, send_start_end); \
     send_func(ep, tag); \
     api_wait(ep, NULL);/* block so we don't run off the stack */ \
     return 0; \
 }
 
-IPC_CALL_FUNC(ipc_call_func, DO_REAL_CALL, seL4_Send, dummy_seL4_Call, end, 0)
-IPC_CALL_FUNC(ipc_call_func2, DO_REAL_CALL, dummy_seL4_Send, seL4_Call, start, 0)
-IPC_CALL_FUNC(ipc_call_10_func, DO_REAL_CALL_10, seL4_Send, dummy_seL4_Call, end, 10)
-IPC_CALL_FUNC(ipc_call_10_func2, DO_REAL_CALL_10, dummy_seL4_Send, seL4_Call, start, 10)
-
-#define IPC_REPLY_RECV_FUNC(name, bench_func, reply_func, recv_func, send_start_end, length) \
+#define IPC_REPLY_RECV_FUNC(name, counter, bench_func, reply_func, recv_func, send_start_end, length) \
 seL4_Word name(int argc, char *argv[]) { \
     uint32_t i; \
-    ccnt_t start UNUSED, end UNUSED; \
+    counter##_DECLS(start) UNUSED; \
+    counter##_DECLS(end) UNUSED; \
     seL4_MessageInfo_t tag = seL4_MessageInfo_new(0, 0, 0, length); \
     seL4_CPtr ep = atoi(argv[0]);\
     seL4_CPtr result_ep = atoi(argv[1]);\
     seL4_CPtr reply = atoi(argv[2]);\
+    UNUSED counter_bitfield_t mask = atol(argv[3]);\
+    POLLUTION_DECLS(argv);\
     if (config_set(CONFIG_KERNEL_RT)) {\
         api_nbsend_recv(ep, tag, ep, NULL, reply);\
     } else {\
@@ -173,63 +179,157 @@ seL4_Word name(int argc, char *argv[]) { \
     }\
     COMPILER_MEMORY_FENCE(); \
     for (i = 0; i < WARMUPS; i++) { \
-        READ_COUNTER_BEFORE(start); \
+        POLLUTE(); \
+        counter##_READ_BEFORE(start); \
         bench_func(ep, tag, reply); \
-        READ_COUNTER_AFTER(end); \
+        counter##_READ_AFTER(end); \
     } \
     COMPILER_MEMORY_FENCE(); \
     reply_func(reply, tag); \
-    send_result(result_ep, send_start_end); \
+    counter##_SEND(result_ep, send_start_end); \
     api_wait(ep, NULL); /* block so we don't run off the stack */ \
     return 0; \
 }
 
-IPC_REPLY_RECV_FUNC(ipc_replyrecv_func2, DO_REAL_REPLY_RECV, api_reply, api_recv, end, 0)
-IPC_REPLY_RECV_FUNC(ipc_replyrecv_func, DO_REAL_REPLY_RECV, dummy_seL4_Reply, api_recv, start, 0)
-IPC_REPLY_RECV_FUNC(ipc_replyrecv_10_func2, DO_REAL_REPLY_RECV_10, api_reply, api_recv, end, 10)
-IPC_REPLY_RECV_FUNC(ipc_replyrecv_10_func, DO_REAL_REPLY_RECV_10, dummy_seL4_Reply, api_recv, start, 10)
-
-seL4_Word
-ipc_recv_func(int argc, char *argv[])
-{
-    uint32_t i;
-    ccnt_t start UNUSED, end UNUSED;
-    seL4_CPtr ep = atoi(argv[0]);
-    seL4_CPtr result_ep = atoi(argv[1]);
-    UNUSED seL4_CPtr reply = atoi(argv[2]);
+#define IPC_RECV_FUNC(name, counter) \
+seL4_Word name(int argc, char *argv[]) { \
+    uint32_t i; \
+    counter##_DECLS(start) UNUSED; \
+    counter##_DECLS(end) UNUSED; \
+    seL4_CPtr ep = atoi(argv[0]); \
+    seL4_CPtr result_ep = atoi(argv[1]); \
+    UNUSED seL4_CPtr reply = atoi(argv[2]); \
+    UNUSED counter_bitfield_t mask = atol(argv[3]); \
+    POLLUTION_DECLS(argv); \
+    COMPILER_MEMORY_FENCE(); \
+    for (i = 0; i < WARMUPS; i++) { \
+        POLLUTE(); \
+        counter##_READ_BEFORE(start); \
+        DO_REAL_RECV(ep, reply); \
+        counter##_READ_AFTER(end); \
+    } \
+    COMPILER_MEMORY_FENCE(); \
+    DO_REAL_RECV(ep, reply); \
+    counter##_SEND(result_ep, end); \
+    return 0; \
+}
 
-    COMPILER_MEMORY_FENCE();
-    for (i = 0; i < WARMUPS; i++) {
-        READ_COUNTER_BEFORE(start);
-        DO_REAL_RECV(ep, reply);
-        READ_COUNTER_AFTER(end);
-    }
-    COMPILER_MEMORY_FENCE();
-    DO_REAL_RECV(ep, reply);
-    send_result(result_ep, end);
-    return 0;
+#define IPC_SEND_FUNC(name, counter) \
+seL4_Word name(int argc, char *argv[]) { \
+    uint32_t i; \
+    counter##_DECLS(start) UNUSED; \
+    counter##_DECLS(end) UNUSED; \
+    seL4_CPtr ep = atoi(argv[0]); \
+    seL4_CPtr result_ep = atoi(argv[1]); \
+    UNUSED counter_bitfield_t mask = atol(argv[3]); \
+    POLLUTION_DECLS(argv); \
+    seL4_MessageInfo_t tag = seL4_MessageInfo_new(0, 0, 0, 0); \
+    COMPILER_MEMORY_FENCE(); \
+    for (i = 0; i < WARMUPS; i++) { \
+        POLLUTE(); \
+        counter##_READ_BEFORE(start); \
+        DO_REAL_SEND(ep, tag); \
+        counter##_READ_AFTER(end); \
+    } \
+    COMPILER_MEMORY_FENCE(); \
+    counter##_SEND(result_ep, start); \
+    DO_REAL_SEND(ep, tag); \
+    return 0; \
 }
 
-seL4_Word
-ipc_send_func(int argc, char *argv[])
+#ifdef CONFIG_KERNEL_RT
+/* reply by sending on the reply object, then wait for the next message */
+#define NBSEND_RECV_REPLY(ep, tag, reply) DO_REAL_NBSEND_RECV(reply, tag, ep, reply)
+
+static inline void
+nbsend_wait(seL4_CPtr ep, seL4_MessageInfo_t tag)
 {
-    uint32_t i;
-    ccnt_t start UNUSED, end UNUSED;
-    seL4_CPtr ep = atoi(argv[0]);
-    seL4_CPtr result_ep = atoi(argv[1]);
-    seL4_MessageInfo_t tag = seL4_MessageInfo_new(0, 0, 0, 0);
-    COMPILER_MEMORY_FENCE();
-    for (i = 0; i < WARMUPS; i++) {
-        READ_COUNTER_BEFORE(start);
-        DO_REAL_SEND(ep, tag);
-        READ_COUNTER_AFTER(end);
-    }
-    COMPILER_MEMORY_FENCE();
-    send_result(result_ep, start);
-    DO_REAL_SEND(ep, tag);
-    return 0;
+    DO_REAL_NBSEND_WAIT(ep, tag, ep);
+}
+
+/* Client and server both run this loop, sending to the ep and then waiting on it. pre_func
+ * and post_func line the iterations up so that the final iteration of the thread recording
+ * start wakes the final iteration of the thread recording end. */
+#define IPC_NBSEND_WAIT_FUNC(name, counter, pre_func, post_func, send_start_end) \
+seL4_Word name(int argc, char *argv[]) { \
+    uint32_t i; \
+    counter##_DECLS(start) UNUSED; \
+    counter##_DECLS(end) UNUSED; \
+    seL4_CPtr ep = atoi(argv[0]); \
+    seL4_CPtr result_ep = atoi(argv[1]); \
+    UNUSED counter_bitfield_t mask = atol(argv[3]); \
+    POLLUTION_DECLS(argv); \
+    seL4_MessageInfo_t tag = seL4_MessageInfo_new(0, 0, 0, 0); \
+    pre_func(ep, tag); \
+    COMPILER_MEMORY_FENCE(); \
+    for (i = 0; i < WARMUPS; i++) { \
+        POLLUTE(); \
+        counter##_READ_BEFORE(start); \
+        DO_REAL_NBSEND_WAIT(ep, tag, ep); \
+        counter##_READ_AFTER(end); \
+    } \
+    COMPILER_MEMORY_FENCE(); \
+    counter##_SEND(result_ep, send_start_end); \
+    post_func(ep, tag); \
+    api_wait(ep, NULL); /* block so we don't run off the stack */ \
+    return 0; \
 }
 
+/* servers start with an nbsend_wait, which tells the driver they are initialised */
+#define IPC_RT_HELPER_FUNCS(prefix, counter) \
+    IPC_REPLY_RECV_FUNC(prefix##_nbsendrecv_func2, counter, NBSEND_RECV_REPLY, api_reply, api_recv, end, 0) \
+    IPC_REPLY_RECV_FUNC(prefix##_nbsendrecv_func, counter, NBSEND_RECV_REPLY, dummy_seL4_Reply, api_recv, start, 0) \
+    IPC_NBSEND_WAIT_FUNC(prefix##_nbsendwait_client_func2, counter, nbsend_wait, dummy_seL4_Send, start) \
+    IPC_NBSEND_WAIT_FUNC(prefix##_nbsendwait_server_func2, counter, nbsend_wait, seL4_Send, end) \
+    IPC_NBSEND_WAIT_FUNC(prefix##_nbsendwait_client_func, counter, dummy_seL4_Send, seL4_Send, end) \
+    IPC_NBSEND_WAIT_FUNC(prefix##_nbsendwait_server_func, counter, nbsend_wait, dummy_seL4_Send, start)
+
+#define IPC_RT_HELPER_FUNC_PTRS(prefix) \
+    prefix##_nbsendrecv_func2, \
+    prefix##_nbsendrecv_func, \
+    prefix##_nbsendwait_client_func2, \
+    prefix##_nbsendwait_server_func2, \
+    prefix##_nbsendwait_client_func, \
+    prefix##_nbsendwait_server_func,
+#else
+#define IPC_RT_HELPER_FUNCS(prefix, counter)
+#define IPC_RT_HELPER_FUNC_PTRS(prefix)
+#endif /* CONFIG_KERNEL_RT */
+
+/* Declare the full set of helper functions for a given counter type, in the order of
+ * helper_func_id_t */
+#define IPC_HELPER_FUNCS(prefix, counter) \
+    IPC_CALL_FUNC(prefix##_call_func, counter, DO_REAL_CALL, seL4_Send, dummy_seL4_Call, end, 0) \
+    IPC_CALL_FUNC(prefix##_call_func2, counter, DO_REAL_CALL, dummy_seL4_Send, seL4_Call, start, 0) \
+    IPC_CALL_FUNC(prefix##_call_10_func, counter, DO_REAL_CALL_10, seL4_Send, dummy_seL4_Call, end, 10) \
+    IPC_CALL_FUNC(prefix##_call_10_func2, counter, DO_REAL_CALL_10, dummy_seL4_Send, seL4_Call, start, 10) \
+    IPC_REPLY_RECV_FUNC(prefix##_replyrecv_func2, counter, DO_REAL_REPLY_RECV, api_reply, api_recv, end, 0) \
+    IPC_REPLY_RECV_FUNC(prefix##_replyrecv_func, counter, DO_REAL_REPLY_RECV, dummy_seL4_Reply, api_recv, start, 0) \
+    IPC_REPLY_RECV_FUNC(prefix##_replyrecv_10_func2, counter, DO_REAL_REPLY_RECV_10, api_reply, api_recv, end, 10) \
+    IPC_REPLY_RECV_FUNC(prefix##_replyrecv_10_func, counter, DO_REAL_REPLY_RECV_10, dummy_seL4_Reply, api_recv, start, 10) \
+    IPC_SEND_FUNC(prefix##_send_func, counter) \
+    IPC_RECV_FUNC(prefix##_recv_func, counter) \
+    IPC_RT_HELPER_FUNCS(prefix, counter) \
+    \
+    static helper_func_t prefix##_funcs[] = { \
+        prefix##_call_func, \
+        prefix##_call_func2, \
+        prefix##_call_10_func, \
+        prefix##_call_10_func2, \
+        prefix##_replyrecv_func2, \
+        prefix##_replyrecv_func, \
+        prefix##_replyrecv_10_func2, \
+        prefix##_replyrecv_10_func, \
+        prefix##_send_func, \
+        prefix##_recv_func, \
+        IPC_RT_HELPER_FUNC_PTRS(prefix) \
+    };
+
+IPC_HELPER_FUNCS(ipc, CCNT)
+#ifdef CONFIG_GENERIC_COUNTER
+IPC_HELPER_FUNCS(ipc_counters, GENERIC)
+#endif
+
 #define MEASURE_OVERHEAD(op, dest, decls) do { \
     uint32_t i; \
     timing_init(); \
@@ -250,7 +350,6 @@ ipc_send_func(int argc, char *argv[])
         } \
         if (results_stable(dest, RUNS)) break; \
     } \
-    timing_destroy(); \
 } while(0)
 
 static void
@@ -274,21 +373,156 @@ measure_overhead(ipc_results_t *results)
     MEASURE_OVERHEAD(DO_NOP_REPLY_RECV_10(0, tag10, 0),
                      results->overhead_benchmarks[REPLY_RECV_10_OVERHEAD],
                      seL4_MessageInfo_t tag10 = seL4_MessageInfo_new(0, 0, 0, 10));
+#ifdef CONFIG_KERNEL_RT
+    MEASURE_OVERHEAD(DO_NOP_NBSEND_RECV(0, tag, 0, 0),
+                     results->overhead_benchmarks[NBSEND_RECV_OVERHEAD],
+                     seL4_MessageInfo_t tag = seL4_MessageInfo_new(0, 0, 0, 0));
+    MEASURE_OVERHEAD(DO_NOP_NBSEND_WAIT(0, tag, 0),
+                     results->overhead_benchmarks[NBSEND_WAIT_OVERHEAD],
+                     seL4_MessageInfo_t tag = seL4_MessageInfo_new(0, 0, 0, 0));
+#endif
+}
+
+#ifdef CONFIG_GENERIC_COUNTER
+/* store the counter values of a chunk of generic counters into dest, which is indexed by event */
+static void
+record_counters(ccnt_t dest[SEL4BENCH_NUM_GENERIC_EVENTS][RUNS], int run, seL4_Word chunk,
+                seL4_Word n_counters, ccnt_t start[], ccnt_t end[])
+{
+    for (seL4_Word i = 0; i < n_counters; i++) {
+        seL4_Word event = chunk * n_counters + i;
+        if (event >= SEL4BENCH_NUM_GENERIC_EVENTS) {
+            break;
+        }
+
+        if (end[i] > start[i]) {
+            dest[event][run] = end[i] - start[i];
+        } else {
+            dest[event][run] = start[i] - end[i];
+        }
+    }
+}
+
+#define MEASURE_COUNTER_OVERHEAD(op, dest, decls) do { \
+    seL4_Word n_counters = sel4bench_get_num_counters(); \
+    timing_init(); \
+    for (seL4_Word chunk = 0; chunk < sel4bench_get_num_generic_counter_chunks(n_counters); chunk++) { \
+        counter_bitfield_t mask = sel4bench_enable_generic_counters(chunk, n_counters); \
+        for (uint32_t j = 0; j < RUNS; j++) { \
+            uint32_t k; \
+            decls; \
+            GENERIC_DECLS(start); \
+            GENERIC_DECLS(end); \
+            COMPILER_MEMORY_FENCE(); \
+            for (k = 0; k < WARMUPS; k++) { \
+                GENERIC_READ_BEFORE(start); \
+                op; \
+                GENERIC_READ_AFTER(end); \
+            } \
+            COMPILER_MEMORY_FENCE(); \
+            record_counters(dest, j, chunk, n_counters, start, end); \
+        } \
+        sel4bench_stop_counters(mask); \
+    } \
+} while(0)
+
+static void
+measure_counter_overhead(ipc_results_t *results)
+{
+    MEASURE_COUNTER_OVERHEAD(DO_NOP_CALL(0, tag),
+                             results->overhead_counters[CALL_OVERHEAD],
+                             seL4_MessageInfo_t tag = seL4_MessageInfo_new(0, 0, 0, 0));
+    MEASURE_COUNTER_OVERHEAD(DO_NOP_REPLY_RECV(0, tag, 0),
+                             results->overhead_counters[REPLY_RECV_OVERHEAD],
+                             seL4_MessageInfo_t tag = seL4_MessageInfo_new(0, 0, 0, 0));
+    MEASURE_COUNTER_OVERHEAD(DO_NOP_SEND(0, tag),
+                             results->overhead_counters[SEND_OVERHEAD],
+                             seL4_MessageInfo_t tag = seL4_MessageInfo_new(0, 0, 0, 0));
+    MEASURE_COUNTER_OVERHEAD(DO_NOP_RECV(0, 0),
+                             results->overhead_counters[RECV_OVERHEAD],
+                             {});
+    MEASURE_COUNTER_OVERHEAD(DO_NOP_CALL_10(0, tag10),
+                             results->overhead_counters[CALL_10_OVERHEAD],
+                             seL4_MessageInfo_t tag10 = seL4_MessageInfo_new(0, 0, 0, 10));
+    MEASURE_COUNTER_OVERHEAD(DO_NOP_REPLY_RECV_10(0, tag10, 0),
+                             results->overhead_counters[REPLY_RECV_10_OVERHEAD],
+                             seL4_MessageInfo_t tag10 = seL4_MessageInfo_new(0, 0, 0, 10));
+#ifdef CONFIG_KERNEL_RT
+    MEASURE_COUNTER_OVERHEAD(DO_NOP_NBSEND_RECV(0, tag, 0, 0),
+                             results->overhead_counters[NBSEND_RECV_OVERHEAD],
+                             seL4_MessageInfo_t tag = seL4_MessageInfo_new(0, 0, 0, 0));
+    MEASURE_COUNTER_OVERHEAD(DO_NOP_NBSEND_WAIT(0, tag, 0),
+                             results->overhead_counters[NBSEND_WAIT_OVERHEAD],
+                             seL4_MessageInfo_t tag = seL4_MessageInfo_new(0, 0, 0, 0));
+#endif
+}
+#endif /* CONFIG_GENERIC_COUNTER */
+
+static void
+set_helper_args(helper_thread_t *helper, counter_bitfield_t mask, size_t pollution_size)
+{
+    sel4utils_create_word_args(helper->argv_strings, helper->argv, NUM_ARGS,
+                               helper->ep, helper->result_ep, helper->reply, mask,
+                               (seL4_Word) helper->pollution, pollution_size, 0);
+}
+
+/* spawn a helper without starting it and save its initial registers, so that each run can
+ * restore them rather than paying for a full respawn. Helpers mostly run in other address
+ * spaces, so their stacks cannot be checkpointed from ours. Only the registers are restored:
+ * the arguments spawning wrote to the helper's stack are never modified. */
+static void
+checkpoint_helper(env_t *env, helper_thread_t *helper)
+{
+    int error = sel4utils_spawn_process(&helper->process, &env->slab_vka, &env->vspace, NUM_ARGS,
+                                        helper->argv, 0);
+    ZF_LOGF_IF(error, "Failed to spawn helper\n");
+
+    error = seL4_TCB_ReadRegisters(helper->process.thread.tcb.cptr, false, 0,
+                                   sizeof(seL4_UserContext) / sizeof(seL4_Word), &helper->regs);
+    ZF_LOGF_IF(error, "Failed to read helper registers\n");
+}
+
+static void
+restore_helper(helper_thread_t *helper)
+{
+    int error = seL4_TCB_WriteRegisters(helper->process.thread.tcb.cptr, true, 0,
+                                        sizeof(seL4_UserContext) / sizeof(seL4_Word), &helper->regs);
+    ZF_LOGF_IF(error, "Failed to restore helper\n");
+}
+
+/* set up and checkpoint client and server to run the helper functions for params, and return
+ * the server */
+static helper_thread_t *
+prepare_bench(env_t *env, const benchmark_params_t *params, helper_func_t funcs[], counter_bitfield_t mask,
+              size_t pollution_size, helper_thread_t *client, helper_thread_t *server_thread, helper_thread_t *server_process)
+{
+    helper_thread_t *server = params->same_vspace ? server_thread : server_process;
+
+    int error = seL4_TCB_SetPriority(client->process.thread.tcb.cptr, params->client_prio);
+    ZF_LOGF_IF(error, "Failed to set client prio");
+    client->process.entry_point = funcs[params->client_fn];
+    set_helper_args(client, mask, pollution_size);
+    checkpoint_helper(env, client);
+
+    error = seL4_TCB_SetPriority(server->process.thread.tcb.cptr, params->server_prio);
+    assert(error == seL4_NoError);
+    server->process.entry_point = funcs[params->server_fn];
+    set_helper_args(server, mask, pollution_size);
+    checkpoint_helper(env, server);
+
+    return server;
 }
 
 void
-run_bench(env_t *env, cspacepath_t result_ep_path, seL4_CPtr ep,
-          const benchmark_params_t *params,
-          ccnt_t *ret1, ccnt_t *ret2,
+run_bench(cspacepath_t result_ep_path, seL4_CPtr ep,
+          const benchmark_params_t *params, size_t n_results,
+          ccnt_t ret1[n_results], ccnt_t ret2[n_results],
           helper_thread_t *client, helper_thread_t *server)
 {
-
-    timing_init();
+    int error;
 
     /* start processes */
-    int error = sel4utils_spawn_process(&server->process, &env->slab_vka, &env->vspace, NUM_ARGS,
-                                           server->argv, 1);
-    ZF_LOGF_IF(error, "Failed to spawn server\n");
+    restore_helper(server);
 
     if (config_set(CONFIG_KERNEL_RT) && params->server_fn != IPC_RECV_FUNC) {
         /* wait for server to tell us its initialised */
@@ -302,11 +536,10 @@ run_bench(env_t *env, cspacepath_t result_ep_path, seL4_CPtr ep,
         }
     }
 
-    error = sel4utils_spawn_process(&client->process, &env->slab_vka, &env->vspace, NUM_ARGS, client->argv, 1);
-    ZF_LOGF_IF(error, "Failed to spawn client\n");
+    restore_helper(client);
 
     /* get results */
-    *ret1 = get_result(result_ep_path.capPtr);
+    get_results(result_ep_path.capPtr, n_results, ret1);
 
     if (config_set(CONFIG_KERNEL_RT) && params->server_fn != IPC_RECV_FUNC && params->passive) {
         /* convert server to active so it can send us the result */
@@ -315,14 +548,198 @@ run_bench(env_t *env, cspacepath_t result_ep_path, seL4_CPtr ep,
         ZF_LOGF_IF(error, "Failed to convert server to active");
     }
 
-    *ret2 = get_result(result_ep_path.capPtr);
+    get_results(result_ep_path.capPtr, n_results, ret2);
 
     /* clean up - clean server first in case it is sharing the client's cspace and vspace */
     seL4_TCB_Suspend(client->process.thread.tcb.cptr);
     seL4_TCB_Suspend(server->process.thread.tcb.cptr);
+}
 
-    timing_destroy();
+#ifdef CONFIG_GENERIC_COUNTER
+/* rerun every benchmark once for each chunk of generic counters the hardware can count at once */
+static void
+run_counter_benches(env_t *env, cspacepath_t result_ep_path, seL4_CPtr ep, ipc_results_t *results,
+                    helper_thread_t *client, helper_thread_t *server_thread,
+                    helper_thread_t *server_process)
+{
+    seL4_Word n_counters = sel4bench_get_num_counters();
+    ccnt_t start[SEL4BENCH_NUM_GENERIC_EVENTS], end[SEL4BENCH_NUM_GENERIC_EVENTS];
+
+    for (seL4_Word chunk = 0; chunk < sel4bench_get_num_generic_counter_chunks(n_counters); chunk++) {
+        ZF_LOGI("Measuring generic counter chunk %zu\n", (size_t) chunk);
+        /* the counters stay enabled for every run of the chunk, as the helpers record
+         * the difference between two reads */
+        timing_init();
+        counter_bitfield_t mask = sel4bench_enable_generic_counters(chunk, n_counters);
+        for (int j = 0; j < ARRAY_SIZE(benchmark_params); j++) {
+            const benchmark_params_t *params = &benchmark_params[j];
+            helper_thread_t *server = prepare_bench(env, params, ipc_counters_funcs, mask, 0, client,
+                                                    server_thread, server_process);
+
+            for (int i = 0; i < RUNS; i++) {
+                run_bench(result_ep_path, ep, params, SEL4BENCH_NUM_GENERIC_EVENTS, end, start,
+                          client, server);
+                record_counters(results->counter_benchmarks[j], i, chunk, n_counters, start, end);
+            }
+        }
+        sel4bench_stop_counters(mask);
+    }
+}
+#endif /* CONFIG_GENERIC_COUNTER */
+
+#ifdef CONFIG_APP_IPC_COLD_CACHE
+/* rerun every benchmark once for each pollution size */
+static void
+run_cold_benches(env_t *env, cspacepath_t result_ep_path, seL4_CPtr ep, ipc_results_t *results,
+                 helper_thread_t *client, helper_thread_t *server_thread,
+                 helper_thread_t *server_process)
+{
+    ccnt_t start, end;
+
+    for (int p = 0; p < ARRAY_SIZE(pollution_sizes); p++) {
+        ZF_LOGI("Measuring cold cache IPC with %zu KiB pollution\n", pollution_sizes[p]);
+        for (int j = 0; j < ARRAY_SIZE(benchmark_params); j++) {
+            const benchmark_params_t *params = &benchmark_params[j];
+            helper_thread_t *server = prepare_bench(env, params, ipc_funcs, 0, pollution_sizes[p] * 1024,
+                                                    client, server_thread, server_process);
+
+            for (int i = 0; i < RUNS; i++) {
+                timing_init();
+                run_bench(result_ep_path, ep, params, 1, &end, &start, client, server);
+
+                if (end > start) {
+                    results->cold_benchmarks[p][j][i] = end - start;
+                } else {
+                    results->cold_benchmarks[p][j][i] = start - end;
+                }
+            }
+        }
+    }
+}
+
+/* allocate the pollution buffer and map it into the client and server process vspaces */
+static void
+init_pollution(env_t *env, helper_thread_t *client, helper_thread_t *server_thread,
+               helper_thread_t *server_process)
+{
+    size_t pages = MAX_POLLUTION_SIZE / PAGE_SIZE_4K;
+    void *pollution = vspace_new_pages(&env->vspace, seL4_AllRights, pages, seL4_PageBits);
+    ZF_LOGF_IF(pollution == NULL, "Failed to allocate pollution buffer");
+
+    client->pollution = vspace_share_mem(&env->vspace, &client->process.vspace, pollution, pages,
+                                         seL4_PageBits, seL4_AllRights, 1);
+    ZF_LOGF_IF(client->pollution == NULL, "Failed to share pollution buffer with client");
+    server_process->pollution = vspace_share_mem(&env->vspace, &server_process->process.vspace,
+                                                 pollution, pages, seL4_PageBits, seL4_AllRights, 1);
+    ZF_LOGF_IF(server_process->pollution == NULL, "Failed to share pollution buffer with server");
+    server_thread->pollution = client->pollution;
 }
+#endif /* CONFIG_APP_IPC_COLD_CACHE */
+
+#ifdef CONFIG_APP_IPC_ADDRESS_SPACES
+/* Servers all wait on the same endpoint. As the endpoint queue is FIFO, each Call from the
+ * client goes to the server that has been waiting longest, so Calls round robin across
+ * all of the servers and every Call switches to a different address space. */
+seL4_Word
+address_space_server_fn(int argc, char *argv[])
+{
+    seL4_CPtr ep = atoi(argv[0]);
+    UNUSED seL4_CPtr reply = atoi(argv[2]);
+    seL4_MessageInfo_t tag = seL4_MessageInfo_new(0, 0, 0, 0);
+
+    if (config_set(CONFIG_KERNEL_RT)) {
+        api_nbsend_recv(ep, tag, ep, NULL, reply);
+    } else {
+        api_recv(ep, NULL, reply);
+    }
+
+    while (true) {
+        DO_REAL_REPLY_RECV(ep, tag, reply);
+    }
+
+    return 0;
+}
+
+seL4_Word
+address_space_client_fn(int argc, char *argv[])
+{
+    seL4_CPtr ep = atoi(argv[0]);
+    seL4_CPtr result_ep = atoi(argv[1]);
+    seL4_Word n_servers = atol(argv[N_SERVERS_ARG]);
+    seL4_MessageInfo_t tag = seL4_MessageInfo_new(0, 0, 0, 0);
+    ccnt_t start, end;
+
+    /* warm up by calling every server once */
+    for (seL4_Word i = 0; i < n_servers; i++) {
+        DO_REAL_CALL(ep, tag);
+    }
+
+    /* time each Call, like the other Call helpers, and report the last */
+    COMPILER_MEMORY_FENCE();
+    for (seL4_Word i = 0; i < n_servers * ADDRESS_SPACE_ROUNDS; i++) {
+        READ_COUNTER_BEFORE(start);
+        DO_REAL_CALL(ep, tag);
+        READ_COUNTER_AFTER(end);
+    }
+    COMPILER_MEMORY_FENCE();
+
+    send_result(result_ep, end - start);
+    api_wait(ep, NULL); /* block so we don't run off the stack */
+    return 0;
+}
+
+static helper_thread_t address_space_servers[MAX_ADDRESS_SPACES];
+
+/* measure round trip Call cost as the number of address spaces the client calls into grows */
+static void
+run_address_space_benches(env_t *env, cspacepath_t ep_path, cspacepath_t result_ep_path,
+                          ipc_results_t *results, helper_thread_t *client)
+{
+    for (int i = 0; i < MAX_ADDRESS_SPACES; i++) {
+        helper_thread_t *server = &address_space_servers[i];
+        benchmark_shallow_clone_process(env, &server->process, seL4_MaxPrio - 1,
+                                        address_space_server_fn, "address space server");
+        server->ep = sel4utils_copy_path_to_process(&server->process, ep_path);
+        server->result_ep = sel4utils_copy_path_to_process(&server->process, result_ep_path);
+        server->reply = SEL4UTILS_REPLY_SLOT;
+        server->pollution = NULL;
+        set_helper_args(server, 0, 0);
+        checkpoint_helper(env, server);
+    }
+
+    int error = seL4_TCB_SetPriority(client->process.thread.tcb.cptr, seL4_MaxPrio - 1);
+    ZF_LOGF_IF(error, "Failed to set client prio");
+    client->process.entry_point = address_space_client_fn;
+
+    for (int a = 0; a < ARRAY_SIZE(address_space_counts); a++) {
+        size_t n_servers = address_space_counts[a];
+        ZF_LOGI("Measuring Call across %zu address spaces\n", n_servers);
+        sel4utils_create_word_args(client->argv_strings, client->argv, NUM_ARGS, client->ep,
+                                   client->result_ep, client->reply, 0, 0, 0, n_servers);
+        checkpoint_helper(env, client);
+
+        for (int i = 0; i < RUNS; i++) {
+            timing_init();
+            for (int j = 0; j < n_servers; j++) {
+                restore_helper(&address_space_servers[j]);
+                if (config_set(CONFIG_KERNEL_RT)) {
+                    /* wait for server to tell us its initialised */
+                    seL4_Wait(ep_path.capPtr, NULL);
+                }
+            }
+
+            restore_helper(client);
+
+            results->address_space_benchmarks[a][i] = get_result(result_ep_path.capPtr);
+
+            seL4_TCB_Suspend(client->process.thread.tcb.cptr);
+            for (int j = 0; j < n_servers; j++) {
+                seL4_TCB_Suspend(address_space_servers[j].process.thread.tcb.cptr);
+            }
+        }
+    }
+}
+#endif /* CONFIG_APP_IPC_ADDRESS_SPACES */
 
 int
 main(int argc, char **argv)
@@ -332,11 +749,11 @@ main(int argc, char **argv)
     cspacepath_t ep_path, result_ep_path;
 
     static size_t object_freq[seL4_ObjectTypeCount] = {
-        [seL4_TCBObject] = 4,
+        [seL4_TCBObject] = N_HELPER_TCBS,
         [seL4_EndpointObject] = 2,
 #ifdef CONFIG_KERNEL_RT
-        [seL4_SchedContextObject] = 4,
-        [seL4_ReplyObject] = 4
+        [seL4_SchedContextObject] = N_HELPER_TCBS,
+        [seL4_ReplyObject] = N_HELPER_TCBS
 #endif
     };
 
@@ -359,6 +776,9 @@ main(int argc, char **argv)
 
     /* measure benchmarking overhead */
     measure_overhead(results);
+#ifdef CONFIG_GENERIC_COUNTER
+    measure_counter_overhead(results);
+#endif
 
     helper_thread_t client, server_thread, server_process;
 
@@ -368,52 +788,41 @@ main(int argc, char **argv)
 
     client.ep = sel4utils_copy_path_to_process(&client.process, ep_path);
     client.result_ep = sel4utils_copy_path_to_process(&client.process, result_ep_path);
+    client.reply = 0;
 
     server_process.ep = sel4utils_copy_path_to_process(&server_process.process, ep_path);
     server_process.result_ep = sel4utils_copy_path_to_process(&server_process.process, result_ep_path);
+    server_process.reply = SEL4UTILS_REPLY_SLOT;
 
     server_thread.ep = client.ep;
     server_thread.result_ep = client.result_ep;
+    server_thread.reply = SEL4UTILS_REPLY_SLOT;
 
-    sel4utils_create_word_args(client.argv_strings, client.argv, NUM_ARGS, client.ep, client.result_ep, 0);
-    sel4utils_create_word_args(server_process.argv_strings, server_process.argv, NUM_ARGS,
-                                server_process.ep, server_process.result_ep, SEL4UTILS_REPLY_SLOT);
-    sel4utils_create_word_args(server_thread.argv_strings, server_thread.argv, NUM_ARGS,
-                                server_thread.ep, server_thread.result_ep, SEL4UTILS_REPLY_SLOT);
+    client.pollution = NULL;
+    server_process.pollution = NULL;
+    server_thread.pollution = NULL;
+#ifdef CONFIG_APP_IPC_COLD_CACHE
+    init_pollution(env, &client, &server_thread, &server_process);
+#endif
 
     /* run the benchmark */
     ccnt_t start, end;
-    for (int i = 0; i < RUNS; i++) {
-        int j;
-        ZF_LOGI("--------------------------------------------------\n");
-        ZF_LOGI("Doing iteration %d\n", i);
-        ZF_LOGI("--------------------------------------------------\n");
-        for (j = 0; j < ARRAY_SIZE(benchmark_params); j++) {
-            const struct benchmark_params* params = &benchmark_params[j];
-            ZF_LOGI("%s\t: IPC duration (%s), client prio: %3d server prio %3d, %s vspace, %s, length %2d\n",
-                    params->name,
-                    params->direction == DIR_TO ? "client --> server" : "server --> client",
-                    params->client_prio, params->server_prio,
-                    params->same_vspace ? "same" : "diff",
-                    (config_set(CONFIG_KERNEL_RT) && params->passive) ? "passive" : "active", params->length);
-
-            /* set up client for benchmark */
-            int error = seL4_TCB_SetPriority(client.process.thread.tcb.cptr, params->client_prio);
-            ZF_LOGF_IF(error, "Failed to set client prio");
-            client.process.entry_point = bench_funcs[params->client_fn];
-
-            if (params->same_vspace) {
-                error = seL4_TCB_SetPriority(server_thread.process.thread.tcb.cptr, params->server_prio);
-                assert(error == seL4_NoError);
-                server_thread.process.entry_point = bench_funcs[params->server_fn];
-            } else {
-                error = seL4_TCB_SetPriority(server_process.process.thread.tcb.cptr, params->server_prio);
-                assert(error == seL4_NoError);
-                server_process.process.entry_point = bench_funcs[params->server_fn];
-            }
-
-            run_bench(env, result_ep_path, ep_path.capPtr, params, &end, &start, &client,
-                      params->same_vspace ? &server_thread : &server_process);
+    for (int j = 0; j < ARRAY_SIZE(benchmark_params); j++) {
+        const struct benchmark_params* params = &benchmark_params[j];
+        ZF_LOGI("%s\t: IPC duration (%s), client prio: %3d server prio %3d, %s vspace, %s, length %2d\n",
+                params->name,
+                params->direction == DIR_TO ? "client --> server" : "server --> client",
+                params->client_prio, params->server_prio,
+                params->same_vspace ? "same" : "diff",
+                (config_set(CONFIG_KERNEL_RT) && params->passive) ? "passive" : "active", params->length);
+
+        /* set up client and server for benchmark */
+        helper_thread_t *server = prepare_bench(env, params, ipc_funcs, 0, 0, &client, &server_thread,
+                                                &server_process);
+
+        for (int i = 0; i < RUNS; i++) {
+            timing_init();
+            run_bench(result_ep_path, ep_path.capPtr, params, 1, &end, &start, &client, server);
 
             if (end > start) {
                 results->benchmarks[j][i] = end - start;
@@ -423,6 +832,20 @@ main(int argc, char **argv)
         }
     }
 
+#ifdef CONFIG_GENERIC_COUNTER
+    run_counter_benches(env, result_ep_path, ep_path.capPtr, results, &client, &server_thread,
+                        &server_process);
+#endif
+
+#ifdef CONFIG_APP_IPC_COLD_CACHE
+    run_cold_benches(env, result_ep_path, ep_path.capPtr, results, &client, &server_thread,
+                     &server_process);
+#endif
+
+#ifdef CONFIG_APP_IPC_ADDRESS_SPACES
+    run_address_space_benches(env, ep_path, result_ep_path, results, &client);
+#endif
+
     /* done -> results are stored in shared memory so we can now return */
     benchmark_finished(EXIT_SUCCESS);
     return 0;
@@ -25,6 +25,9 @@
 #define N_LOW_ARGS 5
 #define N_HIGH_ARGS 4
 #define N_YIELD_ARGS 2
+#define N_QUEUE_ARGS 3
+#define N_THROTTLE_ARGS 5
+#define N_OBSERVER_ARGS 1
 
 void
 abort(void)
@@ -270,6 +273,282 @@ benchmark_prio_processes(env_t *env, seL4_CPtr ep, seL4_CPtr produce, seL4_CPtr
     seL4_TCB_Suspend(low.tcb.cptr);
 }
 
+#ifdef CONFIG_APP_SCHEDULER_QUEUE
+/* threads populating the ready queues */
+static sel4utils_thread_t queue_threads[QUEUE_MAX_THREADS];
+static char queue_args_strings[QUEUE_MAX_THREADS][N_QUEUE_ARGS][WORD_STRING_SIZE];
+static char *queue_argv[QUEUE_MAX_THREADS][N_QUEUE_ARGS];
+
+static void
+queue_spin_fn(int argc, char **argv)
+{
+    while (1);
+}
+
+/* yields round robin with the other threads of its priority. Only the first
+ * thread records the time since the thread before it yielded. */
+static void
+queue_yield_fn(int argc, char **argv)
+{
+    assert(argc == N_QUEUE_ARGS);
+    seL4_CPtr ep = (seL4_CPtr) atol(argv[0]);
+    volatile ccnt_t *last = (volatile ccnt_t *) atol(argv[1]);
+    ccnt_t *results = (ccnt_t *) atol(argv[2]);
+    ccnt_t end;
+
+    if (results == NULL) {
+        while (1) {
+            SEL4BENCH_READ_CCNT(*last);
+            seL4_Yield();
+        }
+    }
+
+    for (int i = 0; i < N_RUNS; i++) {
+        SEL4BENCH_READ_CCNT(end);
+        results[i] = (end - *last);
+        SEL4BENCH_READ_CCNT(*last);
+        seL4_Yield();
+    }
+
+    seL4_Send(ep, seL4_MessageInfo_new(0, 0, 0, 0));
+}
+
+static void
+benchmark_queue_signal(env_t *env, seL4_CPtr ep, seL4_CPtr produce, seL4_CPtr consume,
+                       ccnt_t results[N_QUEUE_LENGTHS][N_RUNS])
+{
+    sel4utils_thread_t high, low;
+    char high_args_strings[N_HIGH_ARGS][WORD_STRING_SIZE];
+    char *high_argv[N_HIGH_ARGS];
+    char low_args_strings[N_LOW_ARGS][WORD_STRING_SIZE];
+    char *low_argv[N_LOW_ARGS];
+    ccnt_t start;
+    UNUSED int error;
+
+    benchmark_configure_thread(env, ep, QUEUE_HIGH_PRIO, "high", &high);
+    benchmark_configure_thread(env, ep, QUEUE_LOW_PRIO, "low", &low);
+
+    sel4utils_create_word_args(high_args_strings, high_argv, N_HIGH_ARGS, produce,
+                               ep, (seL4_Word) &start, consume);
+
+    for (int i = 0; i < N_QUEUE_LENGTHS; i++) {
+        /* the runnable threads are below high and low, so never run while they are measured */
+        for (int j = 0; j < queue_length(i); j++) {
+            error = seL4_TCB_SetPriority(queue_threads[j].tcb.cptr, queue_prio(j));
+            assert(error == seL4_NoError);
+            error = sel4utils_start_thread(&queue_threads[j], (sel4utils_thread_entry_fn) queue_spin_fn,
+                                           (void *) N_QUEUE_ARGS, (void *) queue_argv[j], 1);
+            assert(error == seL4_NoError);
+        }
+
+        sel4utils_create_word_args(low_args_strings, low_argv, N_LOW_ARGS, produce,
+                                   (seL4_Word) &start, (seL4_Word) &results[i], ep, consume);
+
+        error = sel4utils_start_thread(&low, (sel4utils_thread_entry_fn) low_fn, (void *) N_LOW_ARGS, (void *) low_argv, 1);
+        assert(error == seL4_NoError);
+        error = sel4utils_start_thread(&high, (sel4utils_thread_entry_fn) high_fn, (void *) N_HIGH_ARGS, (void *) high_argv, 1);
+        assert(error == seL4_NoError);
+
+        benchmark_wait_children(ep, "children of scheduler benchmark", 2);
+
+        for (int j = 0; j < queue_length(i); j++) {
+            seL4_TCB_Suspend(queue_threads[j].tcb.cptr);
+        }
+    }
+
+    seL4_TCB_Suspend(high.tcb.cptr);
+    seL4_TCB_Suspend(low.tcb.cptr);
+}
+
+static void
+benchmark_queue_yield(env_t *env, seL4_CPtr ep, ccnt_t results[N_QUEUE_LENGTHS][N_RUNS])
+{
+    volatile ccnt_t last;
+    UNUSED int error;
+
+    for (int i = 0; i < N_QUEUE_LENGTHS; i++) {
+        /* start the recording thread last, so the others are queued ahead of it */
+        for (int j = queue_length(i) - 1; j >= 0; j--) {
+            sel4utils_create_word_args(queue_args_strings[j], queue_argv[j], N_QUEUE_ARGS, ep,
+                                       (seL4_Word) &last, j == 0 ? (seL4_Word) results[i] : 0);
+            error = seL4_TCB_SetPriority(queue_threads[j].tcb.cptr, QUEUE_HIGH_PRIO);
+            assert(error == seL4_NoError);
+            error = sel4utils_start_thread(&queue_threads[j], (sel4utils_thread_entry_fn) queue_yield_fn,
+                                           (void *) N_QUEUE_ARGS, (void *) queue_argv[j], 1);
+            assert(error == seL4_NoError);
+        }
+
+        benchmark_wait_children(ep, "yielders", 1);
+
+        for (int j = 0; j < queue_length(i); j++) {
+            seL4_TCB_Suspend(queue_threads[j].tcb.cptr);
+        }
+    }
+}
+#endif /* CONFIG_APP_SCHEDULER_QUEUE */
+
+#ifdef CONFIG_APP_SCHEDULER_PRIO_SWEEP
+static void
+benchmark_prio_sweep(env_t *env, seL4_CPtr ep, seL4_CPtr produce, seL4_CPtr consume,
+                     ccnt_t results[N_SWEEP_PAIRS][N_RUNS])
+{
+    sel4utils_thread_t high, low;
+    char high_args_strings[N_HIGH_ARGS][WORD_STRING_SIZE];
+    char *high_argv[N_HIGH_ARGS];
+    char low_args_strings[N_LOW_ARGS][WORD_STRING_SIZE];
+    char *low_argv[N_LOW_ARGS];
+    ccnt_t start;
+    UNUSED int error;
+
+    benchmark_configure_thread(env, ep, seL4_MinPrio, "high", &high);
+    benchmark_configure_thread(env, ep, seL4_MinPrio, "low", &low);
+
+    sel4utils_create_word_args(high_args_strings, high_argv, N_HIGH_ARGS, produce,
+                               ep, (seL4_Word) &start, consume);
+
+    for (int i = 0; i < N_SWEEP_PRIOS; i++) {
+        error = seL4_TCB_SetPriority(low.tcb.cptr, sweep_prio(i));
+        assert(error == seL4_NoError);
+
+        for (int j = i + 1; j < N_SWEEP_PRIOS; j++) {
+            error = seL4_TCB_SetPriority(high.tcb.cptr, sweep_prio(j));
+            assert(error == seL4_NoError);
+
+            sel4utils_create_word_args(low_args_strings, low_argv, N_LOW_ARGS, produce,
+                                       (seL4_Word) &start, (seL4_Word) results[sweep_pair(i, j)], ep, consume);
+
+            error = sel4utils_start_thread(&low, (sel4utils_thread_entry_fn) low_fn, (void *) N_LOW_ARGS, (void *) low_argv, 1);
+            assert(error == seL4_NoError);
+            error = sel4utils_start_thread(&high, (sel4utils_thread_entry_fn) high_fn, (void *) N_HIGH_ARGS, (void *) high_argv, 1);
+            assert(error == seL4_NoError);
+
+            benchmark_wait_children(ep, "children of scheduler benchmark", 2);
+        }
+    }
+
+    seL4_TCB_Suspend(high.tcb.cptr);
+    seL4_TCB_Suspend(low.tcb.cptr);
+}
+#endif /* CONFIG_APP_SCHEDULER_PRIO_SWEEP */
+
+#ifdef CONFIG_KERNEL_RT
+/* runs while the throttled thread is waiting for its budget to be replenished */
+static void
+observer_fn(int argc, char **argv)
+{
+    assert(argc == N_OBSERVER_ARGS);
+    volatile ccnt_t *last = (volatile ccnt_t *) atol(argv[0]);
+
+    while (1) {
+        SEL4BENCH_READ_CCNT(*last);
+    }
+}
+
+/* spins on the cycle counter without ever blocking, so it only stops running when
+ * it exhausts its budget. Each jump in the counter is a throttle followed by a
+ * replenishment, and the run before it is compared to the share of the
+ * replenishment period the budget allows. */
+static void
+throttle_fn(int argc, char **argv)
+{
+    assert(argc == N_THROTTLE_ARGS);
+    seL4_CPtr ep = (seL4_CPtr) atol(argv[0]);
+    volatile ccnt_t *observer = (volatile ccnt_t *) atol(argv[1]);
+    ccnt_t *overrun = (ccnt_t *) atol(argv[2]);
+    ccnt_t *replenish = (ccnt_t *) atol(argv[3]);
+    const sc_params_t *params = &sc_params[atol(argv[4])];
+    ccnt_t prev, now, run_start;
+    int gaps = 0;
+
+    SEL4BENCH_READ_CCNT(prev);
+    run_start = prev;
+    /* the run before the first throttle started part way through a period, so skip it */
+    while (gaps <= N_RUNS) {
+        SEL4BENCH_READ_CCNT(now);
+        if (now - prev > THROTTLE_GAP_CYCLES) {
+            if (gaps > 0) {
+                uint64_t run = prev - run_start;
+                uint64_t expected = (uint64_t) (now - run_start) * params->budget / params->period;
+                /* the kernel throttles early when less than its minimum budget remains,
+                 * which counts as no overrun */
+                overrun[gaps - 1] = run > expected ? run - expected : 0;
+                replenish[gaps - 1] = now - *observer;
+            }
+            run_start = now;
+            gaps++;
+        }
+        prev = now;
+    }
+
+    seL4_Send(ep, seL4_MessageInfo_new(0, 0, 0, 0));
+    while (1);
+}
+
+static void
+benchmark_sched_ctrl_configure(env_t *env, ccnt_t results[N_SC_PARAMS][N_RUNS])
+{
+    vka_object_t sc;
+    ccnt_t start, end;
+    UNUSED int error;
+
+    error = vka_alloc_sched_context(&env->slab_vka, &sc);
+    ZF_LOGF_IF(error, "Failed to allocate sc");
+
+    for (int i = 0; i < N_SC_PARAMS; i++) {
+        for (int j = 0; j < N_RUNS; j++) {
+            SEL4BENCH_READ_CCNT(start);
+            error = api_sched_ctrl_configure(simple_get_sched_ctrl(&env->simple, 0), sc.cptr,
+                                             sc_params[i].budget, sc_params[i].period,
+                                             sc_params[i].extra_refills, 0);
+            SEL4BENCH_READ_CCNT(end);
+            ZF_LOGF_IF(error, "Failed to configure sc");
+            results[i][j] = end - start;
+        }
+    }
+}
+
+static void
+benchmark_throttle(env_t *env, seL4_CPtr ep, ccnt_t overrun[N_SC_PARAMS][N_RUNS],
+                   ccnt_t replenish[N_SC_PARAMS][N_RUNS])
+{
+    sel4utils_thread_t throttled, observer;
+    char throttle_args_strings[N_THROTTLE_ARGS][WORD_STRING_SIZE];
+    char *throttle_argv[N_THROTTLE_ARGS];
+    char observer_args_strings[N_OBSERVER_ARGS][WORD_STRING_SIZE];
+    char *observer_argv[N_OBSERVER_ARGS];
+    volatile ccnt_t last;
+    UNUSED int error;
+
+    benchmark_configure_thread(env, ep, THROTTLE_PRIO, "throttled", &throttled);
+    benchmark_configure_thread(env, ep, THROTTLE_OBSERVER_PRIO, "observer", &observer);
+
+    sel4utils_create_word_args(observer_args_strings, observer_argv, N_OBSERVER_ARGS, (seL4_Word) &last);
+    error = sel4utils_start_thread(&observer, (sel4utils_thread_entry_fn) observer_fn,
+                                   (void *) N_OBSERVER_ARGS, (void *) observer_argv, 1);
+    assert(error == seL4_NoError);
+
+    for (int i = 0; i < N_SC_PARAMS; i++) {
+        error = api_sched_ctrl_configure(simple_get_sched_ctrl(&env->simple, 0),
+                                         throttled.sched_context.cptr,
+                                         sc_params[i].budget, sc_params[i].period,
+                                         sc_params[i].extra_refills, 0);
+        ZF_LOGF_IF(error, "Failed to configure throttled sc");
+
+        sel4utils_create_word_args(throttle_args_strings, throttle_argv, N_THROTTLE_ARGS, ep,
+                                   (seL4_Word) &last, (seL4_Word) overrun[i],
+                                   (seL4_Word) replenish[i], (seL4_Word) i);
+        error = sel4utils_start_thread(&throttled, (sel4utils_thread_entry_fn) throttle_fn,
+                                       (void *) N_THROTTLE_ARGS, (void *) throttle_argv, 1);
+        assert(error == seL4_NoError);
+
+        benchmark_wait_children(ep, "throttled", 1);
+        seL4_TCB_Suspend(throttled.tcb.cptr);
+    }
+
+    seL4_TCB_Suspend(observer.tcb.cptr);
+}
+#endif /* CONFIG_KERNEL_RT */
+
 void
 measure_signal_overhead(seL4_CPtr ntfn, ccnt_t *results)
 {
@@ -350,11 +629,19 @@ main(int argc, char **argv)
     scheduler_results_t *results;
 
     static size_t object_freq[seL4_ObjectTypeCount] = {
-        [seL4_TCBObject] = 6,
+#ifdef CONFIG_APP_SCHEDULER_QUEUE
+        [seL4_TCBObject] = 12 + QUEUE_MAX_THREADS,
+#ifdef CONFIG_KERNEL_RT
+        [seL4_SchedContextObject] = 13 + QUEUE_MAX_THREADS,
+        [seL4_ReplyObject] = 12 + QUEUE_MAX_THREADS,
+#endif
+#else
+        [seL4_TCBObject] = 10,
 #ifdef CONFIG_KERNEL_RT
-        [seL4_SchedContextObject] = 6,
-        [seL4_ReplyObject] = 6,
+        [seL4_SchedContextObject] = 11,
+        [seL4_ReplyObject] = 10,
 #endif
+#endif /* CONFIG_APP_SCHEDULER_QUEUE */
         [seL4_EndpointObject] = 1,
         [seL4_NotificationObject] = 2,
     };
@@ -382,12 +669,29 @@ main(int argc, char **argv)
     benchmark_prio_processes(env, done_ep.cptr, produce.cptr, consume.cptr,
                                  results->process_results);
     benchmark_set_prio_average(results->set_prio_average);
+#ifdef CONFIG_APP_SCHEDULER_PRIO_SWEEP
+    benchmark_prio_sweep(env, done_ep.cptr, produce.cptr, consume.cptr, results->prio_sweep);
+#endif
 
     /* thread yield benchmarks */
     benchmark_yield_thread(env, done_ep.cptr, results->thread_yield);
     benchmark_yield_process(env, done_ep.cptr, results->process_yield);
     benchmark_yield_average(results->average_yield);
 
+#ifdef CONFIG_APP_SCHEDULER_QUEUE
+    for (int i = 0; i < QUEUE_MAX_THREADS; i++) {
+        benchmark_configure_thread(env, done_ep.cptr, QUEUE_HIGH_PRIO, "queue", &queue_threads[i]);
+    }
+    benchmark_queue_signal(env, done_ep.cptr, produce.cptr, consume.cptr, results->queue_signal);
+    benchmark_queue_yield(env, done_ep.cptr, results->queue_yield);
+#endif /* CONFIG_APP_SCHEDULER_QUEUE */
+
+#ifdef CONFIG_KERNEL_RT
+    /* scheduling context benchmarks */
+    benchmark_sched_ctrl_configure(env, results->sched_ctrl_configure);
+    benchmark_throttle(env, done_ep.cptr, results->throttle_overrun, results->replenish);
+#endif /* CONFIG_KERNEL_RT */
+
     /* done -> results are stored in shared memory so we can now return */
     benchmark_finished(EXIT_SUCCESS);
     return 0;
@@ -44,6 +44,7 @@ typedef struct {
     double median;
     double first_quantile;
     double third_quantile;
+    double percentile_99;
     size_t samples;
     ccnt_t *raw_data;
 } result_t;
@@ -98,7 +99,11 @@ benchmark_t *fault_benchmark_new(void);
 benchmark_t *hardware_benchmark_new(void);
 benchmark_t *sync_benchmark_new(void);
 benchmark_t *page_mapping_benchmark_new(void);
-benchmark_t *smp_benchmark_new(void);
+benchmark_t *smp_benchmark_new(simple_t *simple);
+benchmark_t *wakeup_benchmark_new(void);
+benchmark_t *taskset_benchmark_new(void);
+benchmark_t *domain_benchmark_new(void);
+benchmark_t *eventloop_benchmark_new(void);
 
 static inline void
 blank_init(UNUSED vka_t *vka, UNUSED simple_t *simple, UNUSED sel4utils_process_t *process)
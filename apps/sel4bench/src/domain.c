@@ -0,0 +1,129 @@
+/*
+ * Copyright 2017, Data61
+ * Commonwealth Scientific and Industrial Research Organisation (CSIRO)
+ * ABN 41 687 119 230.
+ *
+ * This software may be distributed and modified according to the terms of
+ * the GNU General Public License version 2. Note that NO WARRANTY is provided.
+ * See "LICENSE_GPLv2.txt" for details.
+ *
+ * @TAG(DATA61_GPL)
+ */
+#include <autoconf.h>
+#include <jansson.h>
+#include <sel4bench/sel4bench.h>
+#include <utils/util.h>
+#include <domain.h>
+
+#include "benchmark.h"
+#include "json.h"
+#include "processing.h"
+
+static json_t *
+domain_process(void *r)
+{
+    domain_results_t *raw_results = r;
+    json_t *array = json_array();
+
+    result_desc_t desc = {
+        .stable = true,
+        .name = "Read ccnt overhead",
+        .ignored = N_IGNORED,
+    };
+    result_t result = process_result(N_RUNS, raw_results->ccnt_overhead, desc);
+
+    result_set_t set = {
+        .name = "Read ccnt overhead",
+        .n_extra_cols = 0,
+        .results = &result,
+        .n_results = 1,
+    };
+    json_array_append_new(array, result_set_to_json(set));
+
+    desc.stable = false;
+    desc.overhead = result.min;
+
+    set.name = "Domain switch";
+    result = process_result(N_RUNS, raw_results->switch_latency, desc);
+    json_array_append_new(array, result_set_to_json(set));
+
+    /* the walks are timed the same way, so compare them directly */
+    result_t walk_results[N_DOMAIN_WORKING_SETS * 2];
+    char *state_col[N_DOMAIN_WORKING_SETS * 2];
+    json_int_t walk_size_col[N_DOMAIN_WORKING_SETS * 2];
+    for (int s = 0; s < N_DOMAIN_WORKING_SETS; s++) {
+        walk_results[s * 2] = process_result(N_RUNS, raw_results->cold_walk[s], desc);
+        walk_results[s * 2 + 1] = process_result(N_RUNS, raw_results->warm_walk[s], desc);
+        state_col[s * 2] = "After domain switch";
+        state_col[s * 2 + 1] = "Warm";
+        walk_size_col[s * 2] = domain_working_set_sizes[s] * 1024;
+        walk_size_col[s * 2 + 1] = domain_working_set_sizes[s] * 1024;
+    }
+
+    column_t extra_cols[] = {
+        {
+            .header = "Working set",
+            .type = JSON_STRING,
+            .string_array = state_col,
+        },
+        {
+            .header = "Size (bytes)",
+            .type = JSON_INTEGER,
+            .integer_array = walk_size_col,
+        },
+    };
+
+    set = (result_set_t) {
+        .name = "Working set walk",
+        .extra_cols = extra_cols,
+        .n_extra_cols = ARRAY_SIZE(extra_cols),
+        .results = walk_results,
+        .n_results = ARRAY_SIZE(walk_results),
+    };
+    json_array_append_new(array, result_set_to_json(set));
+
+    /* the cost to the preempted domain of refilling its working set, per switch */
+    result_t refill_results[N_DOMAIN_WORKING_SETS];
+    json_int_t refill_size_col[N_DOMAIN_WORKING_SETS];
+    ccnt_t refill[N_RUNS];
+    desc.overhead = 0;
+    for (int s = 0; s < N_DOMAIN_WORKING_SETS; s++) {
+        for (int i = 0; i < N_RUNS; i++) {
+            refill[i] = raw_results->cold_walk[s][i] > raw_results->warm_walk[s][i] ?
+                        raw_results->cold_walk[s][i] - raw_results->warm_walk[s][i] : 0;
+        }
+        refill_results[s] = process_result(N_RUNS, refill, desc);
+        refill_size_col[s] = domain_working_set_sizes[s] * 1024;
+    }
+
+    column_t refill_col = {
+        .header = "Size (bytes)",
+        .type = JSON_INTEGER,
+        .integer_array = refill_size_col,
+    };
+
+    set = (result_set_t) {
+        .name = "Working set refill after domain switch",
+        .extra_cols = &refill_col,
+        .n_extra_cols = 1,
+        .results = refill_results,
+        .n_results = ARRAY_SIZE(refill_results),
+    };
+    json_array_append_new(array, result_set_to_json(set));
+
+    return array;
+}
+
+static benchmark_t domain_benchmark = {
+    .name = "domain",
+    .enabled = config_set(CONFIG_APP_DOMAINBENCH),
+    .results_pages = BYTES_TO_SIZE_BITS_PAGES(sizeof(domain_results_t), seL4_PageBits),
+    .process = domain_process,
+    .init = blank_init
+};
+
+benchmark_t *
+domain_benchmark_new(void)
+{
+    return &domain_benchmark;
+}
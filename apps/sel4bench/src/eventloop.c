@@ -0,0 +1,125 @@
+/*
+ * Copyright 2017, Data61
+ * Commonwealth Scientific and Industrial Research Organisation (CSIRO)
+ * ABN 41 687 119 230.
+ *
+ * This software may be distributed and modified according to the terms of
+ * the GNU General Public License version 2. Note that NO WARRANTY is provided.
+ * See "LICENSE_GPLv2.txt" for details.
+ *
+ * @TAG(DATA61_GPL)
+ */
+#include <autoconf.h>
+#include <jansson.h>
+#include <sel4bench/sel4bench.h>
+#include <utils/util.h>
+#include <eventloop.h>
+
+#include "benchmark.h"
+#include "json.h"
+#include "processing.h"
+
+/* the two pure mixes have one event each, the others have both */
+#define N_EVENTLOOP_ROWS (2 + (N_EVENTLOOP_MIXES - 2) * N_EVENT_TYPES)
+
+static char *mix_names[N_EVENTLOOP_MIXES] = {
+    [MIX_IPC] = "IPC only",
+    [MIX_SIGNAL] = "Signal only",
+    [MIX_ALTERNATE] = "Alternating",
+    [MIX_RANDOM] = "Random",
+};
+
+static char *event_names[N_EVENT_TYPES] = {
+    [EVENT_IPC] = "IPC",
+    [EVENT_SIGNAL] = "Bound notification signal",
+};
+
+/* one row for each event of each mix */
+static void
+process_mix_results(ccnt_t raw_results[N_EVENTLOOP_MIXES][N_EVENT_TYPES][N_RUNS], char *name,
+                    result_desc_t desc, json_t *array)
+{
+    result_t results[N_EVENTLOOP_ROWS];
+    char *mix_col[N_EVENTLOOP_ROWS];
+    char *event_col[N_EVENTLOOP_ROWS];
+
+    int row = 0;
+    for (int mix = 0; mix < N_EVENTLOOP_MIXES; mix++) {
+        for (int event = 0; event < N_EVENT_TYPES; event++) {
+            if (!eventloop_mix_has(mix, event)) {
+                continue;
+            }
+            assert(row < N_EVENTLOOP_ROWS);
+            results[row] = process_result(N_RUNS, raw_results[mix][event], desc);
+            mix_col[row] = mix_names[mix];
+            event_col[row] = event_names[event];
+            row++;
+        }
+    }
+
+    column_t extra_cols[] = {
+        {
+            .header = "Mix",
+            .type = JSON_STRING,
+            .string_array = mix_col,
+        },
+        {
+            .header = "Event",
+            .type = JSON_STRING,
+            .string_array = event_col,
+        },
+    };
+
+    result_set_t set = {
+        .name = name,
+        .extra_cols = extra_cols,
+        .n_extra_cols = ARRAY_SIZE(extra_cols),
+        .results = results,
+        .n_results = row,
+    };
+    json_array_append_new(array, result_set_to_json(set));
+}
+
+static json_t *
+eventloop_process(void *r)
+{
+    eventloop_results_t *raw_results = r;
+    json_t *array = json_array();
+
+    result_desc_t desc = {
+        .stable = true,
+        .name = "Read ccnt overhead",
+        .ignored = N_IGNORED,
+    };
+    result_t result = process_result(N_RUNS, raw_results->ccnt_overhead, desc);
+
+    result_set_t set = {
+        .name = "Read ccnt overhead",
+        .n_extra_cols = 0,
+        .results = &result,
+        .n_results = 1,
+    };
+    json_array_append_new(array, result_set_to_json(set));
+
+    desc.stable = false;
+    desc.overhead = result.min;
+
+    process_mix_results(raw_results->arrival, "Event arrival at server", desc, array);
+    process_mix_results(raw_results->handled, "Event handled by server", desc, array);
+
+    return array;
+}
+
+static benchmark_t eventloop_benchmark = {
+    .name = "eventloop",
+    .enabled = config_set(CONFIG_APP_EVENTLOOPBENCH),
+    .results_pages = BYTES_TO_SIZE_BITS_PAGES(sizeof(eventloop_results_t), seL4_PageBits),
+    .process = eventloop_process,
+    .init = blank_init
+};
+
+benchmark_t *
+eventloop_benchmark_new(void)
+{
+    return &eventloop_benchmark;
+}
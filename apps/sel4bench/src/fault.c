@@ -50,6 +50,12 @@ fault_process(void *results) {
     result = process_result(N_RUNS, raw_results->fault, desc);
     json_array_append_new(array, result_set_to_json(set));
 
+#ifdef CONFIG_KERNEL_RT
+    set.name = "budget expiry -> timeout fault handler";
+    result = process_result(N_RUNS, raw_results->timeout_fault, desc);
+    json_array_append_new(array, result_set_to_json(set));
+#endif
+
     /* calculate the overhead of reading the cycle count (fault handler -> faulter path
      * does not include a call to seL4_ReplyRecv_ */
 
@@ -66,6 +72,12 @@ fault_process(void *results) {
     result = process_result(N_RUNS, raw_results->fault_reply, desc);
     json_array_append_new(array, result_set_to_json(set));
 
+#ifdef CONFIG_KERNEL_RT
+    set.name = "timeout fault handler -> faulter";
+    result = process_result(N_RUNS, raw_results->timeout_fault_reply, desc);
+    json_array_append_new(array, result_set_to_json(set));
+#endif
+
     return array;
 }
 
@@ -21,6 +21,130 @@
 #include "printing.h"
 #include "processing.h"
 
+#ifdef CONFIG_GENERIC_COUNTER
+#define N_COUNTER_COLS SEL4BENCH_NUM_GENERIC_EVENTS
+#else
+#define N_COUNTER_COLS 0
+#endif
+
+#ifdef CONFIG_APP_IPC_COLD_CACHE
+static json_t *
+process_cold_results(ipc_results_t *raw_results, ccnt_t overheads[NUM_OVERHEAD_BENCHMARKS])
+{
+    int n = ARRAY_SIZE(pollution_sizes) * ARRAY_SIZE(benchmark_params);
+    char *functions[n];
+    char *directions[n];
+    bool same_vspace[n];
+    json_int_t length[n];
+    bool passive[n];
+    json_int_t pollution[n];
+
+    column_t extra_cols[] = {
+        {
+            .header = "Function",
+            .type = JSON_STRING,
+            .string_array = &functions[0]
+        },
+        {
+            .header = "Direction",
+            .type = JSON_STRING,
+            .string_array = &directions[0],
+        },
+        {
+            .header = "Same vspace?",
+            .type = JSON_TRUE,
+            .bool_array = &same_vspace[0]
+        },
+        {
+            .header = "IPC length",
+            .type = JSON_INTEGER,
+            .integer_array = &length[0]
+        },
+        {
+            .header = "Passive server?",
+            .type = JSON_TRUE,
+            .bool_array = &passive[0]
+        },
+        {
+            .header = "Pollution (KiB)",
+            .type = JSON_INTEGER,
+            .integer_array = &pollution[0]
+        }
+    };
+
+    result_t results[n];
+
+    result_set_t result_set = {
+        .name = "One way IPC microbenchmarks (cold cache)",
+        .extra_cols = extra_cols,
+        .n_extra_cols = ARRAY_SIZE(extra_cols),
+        .results = results,
+        .n_results = n,
+    };
+
+    int row = 0;
+    for (int p = 0; p < ARRAY_SIZE(pollution_sizes); p++) {
+        for (int i = 0; i < ARRAY_SIZE(benchmark_params); i++) {
+            result_desc_t desc = {
+                .name = benchmark_params[i].name,
+                .overhead = overheads[benchmark_params[i].overhead_id],
+            };
+
+            functions[row] = (char *) benchmark_params[i].name;
+            directions[row] = benchmark_params[i].direction == DIR_TO ? "client->server" :
+                                                                        "server->client";
+            same_vspace[row] = benchmark_params[i].same_vspace;
+            length[row] = benchmark_params[i].length;
+            passive[row] = config_set(CONFIG_KERNEL_RT) && benchmark_params[i].passive;
+            pollution[row] = pollution_sizes[p];
+
+            results[row] = process_result(RUNS, raw_results->cold_benchmarks[p][i], desc);
+            row++;
+        }
+    }
+
+    return result_set_to_json(result_set);
+}
+#endif /* CONFIG_APP_IPC_COLD_CACHE */
+
+#ifdef CONFIG_APP_IPC_ADDRESS_SPACES
+static json_t *
+process_address_space_results(ipc_results_t *raw_results, ccnt_t overheads[NUM_OVERHEAD_BENCHMARKS])
+{
+    int n = ARRAY_SIZE(address_space_counts);
+    json_int_t address_spaces[n];
+
+    column_t extra_cols[] = {
+        {
+            .header = "Address spaces",
+            .type = JSON_INTEGER,
+            .integer_array = &address_spaces[0]
+        }
+    };
+
+    result_t results[n];
+
+    result_set_t result_set = {
+        .name = "seL4_Call round robin across address spaces",
+        .extra_cols = extra_cols,
+        .n_extra_cols = ARRAY_SIZE(extra_cols),
+        .results = results,
+        .n_results = n,
+    };
+
+    for (int i = 0; i < n; i++) {
+        result_desc_t desc = {
+            .name = "seL4_Call",
+            .overhead = overheads[CALL_OVERHEAD],
+        };
+        address_spaces[i] = address_space_counts[i];
+        results[i] = process_result(RUNS, raw_results->address_space_benchmarks[i], desc);
+    }
+
+    return result_set_to_json(result_set);
+}
+#endif /* CONFIG_APP_IPC_ADDRESS_SPACES */
+
 static json_t *
 process_ipc_results(void *r)
 {
@@ -48,6 +172,25 @@ process_ipc_results(void *r)
         overheads[i] = overhead_result.min;
     }
 
+#ifdef CONFIG_GENERIC_COUNTER
+    /* generic counter overheads are not checked for stability, as some events
+     * (e.g cache misses) are expected to vary */
+    ccnt_t counter_overheads[NUM_OVERHEAD_BENCHMARKS][SEL4BENCH_NUM_GENERIC_EVENTS];
+    for (int i = 0; i < NUM_OVERHEAD_BENCHMARKS; i++) {
+        for (int e = 0; e < SEL4BENCH_NUM_GENERIC_EVENTS; e++) {
+            result_desc_t desc = {
+                .stable = false,
+                .name = "counter overhead",
+                .ignored = 0,
+                .overhead = 0
+            };
+            result_t overhead_result;
+            overhead_result = process_result(RUNS - 1, &raw_results->overhead_counters[i][e][1], desc);
+            counter_overheads[i][e] = overhead_result.min;
+        }
+    }
+#endif
+
     int n = ARRAY_SIZE(benchmark_params);
     char *functions[n];
     char *directions[n];
@@ -55,8 +198,9 @@ process_ipc_results(void *r)
     json_int_t server_prios[n];
     bool same_vspace[n];
     json_int_t length[n];
+    bool passive[n];
 
-    column_t extra_cols[] = {
+    column_t extra_cols[7 + N_COUNTER_COLS] = {
         {
             .header = "Function",
             .type = JSON_STRING,
@@ -86,9 +230,26 @@ process_ipc_results(void *r)
             .header = "IPC length",
             .type = JSON_INTEGER,
             .integer_array = &length[0]
+        },
+        {
+            .header = "Passive server?",
+            .type = JSON_TRUE,
+            .bool_array = &passive[0]
         }
     };
 
+#ifdef CONFIG_GENERIC_COUNTER
+    /* one column per generic event, holding the median count for each benchmark */
+    double counters[SEL4BENCH_NUM_GENERIC_EVENTS][n];
+    for (int e = 0; e < SEL4BENCH_NUM_GENERIC_EVENTS; e++) {
+        extra_cols[7 + e] = (column_t) {
+            .header = (char *) GENERIC_EVENT_NAMES[e],
+            .type = JSON_REAL,
+            .real_array = &counters[e][0]
+        };
+    }
+#endif
+
     result_t results[n];
 
     result_set_t result_set = {
@@ -113,12 +274,30 @@ process_ipc_results(void *r)
         server_prios[i] = benchmark_params[i].server_prio;
         same_vspace[i] = benchmark_params[i].same_vspace;
         length[i] = benchmark_params[i].length;
+        passive[i] = config_set(CONFIG_KERNEL_RT) && benchmark_params[i].passive;
 
         results[i] = process_result(RUNS, raw_results->benchmarks[i], desc);
+
+#ifdef CONFIG_GENERIC_COUNTER
+        for (int e = 0; e < SEL4BENCH_NUM_GENERIC_EVENTS; e++) {
+            result_desc_t counter_desc = {
+                .name = GENERIC_EVENT_NAMES[e],
+                .overhead = counter_overheads[benchmark_params[i].overhead_id][e],
+            };
+            counters[e][i] = process_result(RUNS, raw_results->counter_benchmarks[i][e],
+                                            counter_desc).median;
+        }
+#endif
     }
 
     json_t *array = json_array();
     json_array_append_new(array, result_set_to_json(result_set));
+#ifdef CONFIG_APP_IPC_COLD_CACHE
+    json_array_append_new(array, process_cold_results(raw_results, overheads));
+#endif
+#ifdef CONFIG_APP_IPC_ADDRESS_SPACES
+    json_array_append_new(array, process_address_space_results(raw_results, overheads));
+#endif
     return array;
 }
 
@@ -52,13 +52,16 @@ result_to_json(result_t result, json_t *j)
    error = json_object_set_new(j, "3rd quantile", json_real_check(result.third_quantile));
    assert(error == 0);
 
+   error = json_object_set_new(j, "99th percentile", json_real_check(result.percentile_99));
+   assert(error == 0);
+
    error = json_object_set_new(j, "Samples", json_integer(result.samples));
    assert(error == 0);
 
    json_t *raw_results = json_array();
    assert(raw_results != NULL);
 
-   if (config_set(CONFIG_OUTPUT_RAW_RESULTS)) {
+   if (config_set(CONFIG_OUTPUT_RAW_RESULTS) && result.raw_data != NULL) {
       for (size_t i = 0; i < result.samples; i++) {
          error = json_array_append_new(raw_results, json_integer(result.raw_data[i]));
          assert(error == 0);
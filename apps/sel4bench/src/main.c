@@ -121,6 +121,10 @@ run_benchmark(env_t *env, benchmark_t *benchmark, void *local_results_vaddr, ben
             sel4utils_copy_cap_to_process(&process, &env->vka, sched_ctrl);
         }
     }
+#if CONFIG_NUM_DOMAINS > 1
+    /* allow benchmarks to move threads into other domains */
+    args->domain = sel4utils_copy_cap_to_process(&process, &env->vka, seL4_CapDomain);
+#endif
 
     /* copy serial to process */
     args->serial_ep = serial_server_parent_mint_endpoint_to_process(&process);
@@ -260,7 +264,11 @@ main_continued(void *arg)
         sync_benchmark_new(),
         /* add new benchmarks here */
         page_mapping_benchmark_new(),
-        smp_benchmark_new(),
+        smp_benchmark_new(&global_env.simple),
+        wakeup_benchmark_new(),
+        taskset_benchmark_new(),
+        domain_benchmark_new(),
+        eventloop_benchmark_new(),
 
         /* null terminator */
         NULL
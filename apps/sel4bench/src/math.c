@@ -162,6 +162,7 @@ calculate_results(const size_t n, ccnt_t data[n])
     result.median = results_median(n, sorted_data);
     result.first_quantile = results_quantile(n, sorted_data, 0.25f);
     result.third_quantile = results_quantile(n, sorted_data, 0.75f);
+    result.percentile_99 = results_quantile(n, sorted_data, 0.99f);
     result.mode = results_mode(n, sorted_data);
     result.raw_data = data;
     result.samples = n;
@@ -15,6 +15,7 @@
 
 #include <scheduler.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 static void
 process_yield_results(scheduler_results_t *results, ccnt_t overhead, json_t *array)
@@ -45,6 +46,170 @@ process_yield_results(scheduler_results_t *results, ccnt_t overhead, json_t *arr
                                                            average_results));
 }
 
+#ifdef CONFIG_APP_SCHEDULER_QUEUE
+static void
+process_queue_results(scheduler_results_t *results, ccnt_t signal_overhead, ccnt_t ccnt_overhead,
+                      json_t *array)
+{
+    result_desc_t desc = {
+        .ignored = N_IGNORED,
+        .overhead = signal_overhead,
+    };
+    result_t per_length_result[N_QUEUE_LENGTHS];
+
+    json_int_t length_col[N_QUEUE_LENGTHS], prios_col[N_QUEUE_LENGTHS];
+    for (int i = 0; i < N_QUEUE_LENGTHS; i++) {
+        length_col[i] = queue_length(i);
+        prios_col[i] = MIN(queue_length(i), CONFIG_APP_SCHEDULER_QUEUE_PRIOS);
+    }
+
+    column_t extra[] = {
+        {
+            .header = "Runnable threads",
+            .type = JSON_INTEGER,
+            .integer_array = length_col,
+        },
+        {
+            .header = "Prios",
+            .type = JSON_INTEGER,
+            .integer_array = prios_col,
+        },
+    };
+
+    result_set_t set = {
+        .name = "Signal to thread of higher prio with runnable threads",
+        .extra_cols = extra,
+        .n_extra_cols = ARRAY_SIZE(extra),
+        .results = per_length_result,
+        .n_results = N_QUEUE_LENGTHS,
+    };
+
+    process_results(N_QUEUE_LENGTHS, N_RUNS, results->queue_signal, desc, per_length_result);
+    json_array_append_new(array, result_set_to_json(set));
+
+    /* round robin is between threads of the same prio */
+    set.name = "Thread yield round robin";
+    set.n_extra_cols = 1;
+    desc.overhead = ccnt_overhead;
+    process_results(N_QUEUE_LENGTHS, N_RUNS, results->queue_yield, desc, per_length_result);
+    json_array_append_new(array, result_set_to_json(set));
+}
+#endif /* CONFIG_APP_SCHEDULER_QUEUE */
+
+#ifdef CONFIG_APP_SCHEDULER_PRIO_SWEEP
+/* one row for each (low, high) pair on the grid, so it can be plotted as a matrix */
+static void
+process_prio_sweep_results(scheduler_results_t *results, ccnt_t signal_overhead, json_t *array)
+{
+    result_desc_t desc = {
+        .ignored = N_IGNORED,
+        .overhead = signal_overhead,
+    };
+    int n = N_SWEEP_PAIRS;
+    result_t *per_pair_result = calloc(n, sizeof(result_t));
+    json_int_t *low_col = calloc(n, sizeof(json_int_t));
+    json_int_t *high_col = calloc(n, sizeof(json_int_t));
+    ZF_LOGF_IF(per_pair_result == NULL || low_col == NULL || high_col == NULL,
+               "Failed to allocate priority sweep results");
+
+    int row = 0;
+    for (int i = 0; i < N_SWEEP_PRIOS; i++) {
+        for (int j = i + 1; j < N_SWEEP_PRIOS; j++) {
+            per_pair_result[row] = process_result(N_RUNS, results->prio_sweep[sweep_pair(i, j)], desc);
+            /* the raw samples of every pair would not fit in the output */
+            per_pair_result[row].raw_data = NULL;
+            low_col[row] = sweep_prio(i);
+            high_col[row] = sweep_prio(j);
+            row++;
+        }
+    }
+
+    column_t extra[] = {
+        {
+            .header = "Low prio",
+            .type = JSON_INTEGER,
+            .integer_array = low_col,
+        },
+        {
+            .header = "High prio",
+            .type = JSON_INTEGER,
+            .integer_array = high_col,
+        },
+    };
+
+    result_set_t set = {
+        .name = "Signal to thread of higher prio, priority sweep",
+        .extra_cols = extra,
+        .n_extra_cols = ARRAY_SIZE(extra),
+        .results = per_pair_result,
+        .n_results = n,
+    };
+    json_array_append_new(array, result_set_to_json(set));
+
+    free(per_pair_result);
+    free(low_col);
+    free(high_col);
+}
+#endif /* CONFIG_APP_SCHEDULER_PRIO_SWEEP */
+
+#ifdef CONFIG_KERNEL_RT
+static void
+process_sched_context_results(scheduler_results_t *results, ccnt_t ccnt_overhead, json_t *array)
+{
+    result_desc_t desc = {
+        .ignored = N_IGNORED,
+        .overhead = ccnt_overhead,
+    };
+    result_t per_params_result[N_SC_PARAMS];
+
+    json_int_t budget_col[N_SC_PARAMS], period_col[N_SC_PARAMS], refills_col[N_SC_PARAMS];
+    for (int i = 0; i < N_SC_PARAMS; i++) {
+        budget_col[i] = sc_params[i].budget;
+        period_col[i] = sc_params[i].period;
+        refills_col[i] = sc_params[i].extra_refills;
+    }
+
+    column_t extra[] = {
+        {
+            .header = "Budget (us)",
+            .type = JSON_INTEGER,
+            .integer_array = budget_col,
+        },
+        {
+            .header = "Period (us)",
+            .type = JSON_INTEGER,
+            .integer_array = period_col,
+        },
+        {
+            .header = "Extra refills",
+            .type = JSON_INTEGER,
+            .integer_array = refills_col,
+        },
+    };
+
+    result_set_t set = {
+        .name = "SchedControl_Configure",
+        .extra_cols = extra,
+        .n_extra_cols = ARRAY_SIZE(extra),
+        .results = per_params_result,
+        .n_results = N_SC_PARAMS,
+    };
+
+    process_results(N_SC_PARAMS, N_RUNS, results->sched_ctrl_configure, desc, per_params_result);
+    json_array_append_new(array, result_set_to_json(set));
+
+    set.name = "Replenish throttled thread";
+    process_results(N_SC_PARAMS, N_RUNS, results->replenish, desc, per_params_result);
+    json_array_append_new(array, result_set_to_json(set));
+
+    /* the overrun is already relative to the budget */
+    set.name = "Budget overrun before throttle";
+    desc.overhead = 0;
+    process_results(N_SC_PARAMS, N_RUNS, results->throttle_overrun, desc, per_params_result);
+    json_array_append_new(array, result_set_to_json(set));
+}
+#endif /* CONFIG_KERNEL_RT */
+
 static void
 process_scheduler_results(scheduler_results_t *results, json_t *array)
 {
@@ -95,6 +260,10 @@ process_scheduler_results(scheduler_results_t *results, json_t *array)
     process_results(N_PRIOS, N_RUNS, results->process_results, desc, per_prio_result);
     json_array_append_new(array, result_set_to_json(set));
 
+#ifdef CONFIG_APP_SCHEDULER_PRIO_SWEEP
+    process_prio_sweep_results(results, desc.overhead, array);
+#endif
+
     result_t average_results[NUM_AVERAGE_EVENTS];
     process_average_results(N_RUNS, NUM_AVERAGE_EVENTS, results->set_prio_average, average_results);
     json_array_append_new(array, average_counters_to_json("Average to reschedule current thread",
@@ -127,6 +296,20 @@ scheduler_process(void *results) {
 
     process_yield_results(raw_results, ccnt_overhead.min, array);
 
+#ifdef CONFIG_APP_SCHEDULER_QUEUE
+    result_desc_t signal_desc = {
+        .stable = true,
+        .name = "Signal overhead",
+        .ignored = N_IGNORED,
+    };
+    result_t signal_overhead = process_result(N_RUNS, raw_results->overhead_signal, signal_desc);
+    process_queue_results(raw_results, signal_overhead.min, ccnt_overhead.min, array);
+#endif /* CONFIG_APP_SCHEDULER_QUEUE */
+
+#ifdef CONFIG_KERNEL_RT
+    process_sched_context_results(raw_results, ccnt_overhead.min, array);
+#endif
+
     return array;
 }
 
@@ -16,6 +16,166 @@
 #include <sel4benchsupport/signal.h>
 #include <stdio.h>
 
+/* one row for each (signaller, waiter) pair of the grid */
+static void
+process_grid_results(signal_results_t *raw_results, ccnt_t overhead, json_t *array)
+{
+    result_desc_t desc = {
+        .ignored = N_IGNORED,
+        .overhead = overhead,
+    };
+    result_t results[N_SIGNAL_PRIOS * (N_SIGNAL_PRIOS - 1)];
+    json_int_t signal_col[ARRAY_SIZE(results)], wait_col[ARRAY_SIZE(results)];
+
+    int row = 0;
+    for (int i = 0; i < N_SIGNAL_PRIOS; i++) {
+        for (int j = 0; j < N_SIGNAL_PRIOS; j++) {
+            if (i == j) {
+                continue;
+            }
+            results[row] = process_result(N_RUNS, raw_results->grid_results[i][j], desc);
+            signal_col[row] = signal_prio(i);
+            wait_col[row] = signal_prio(j);
+            row++;
+        }
+    }
+
+    column_t extra[] = {
+        {
+            .header = "Signaller prio",
+            .type = JSON_INTEGER,
+            .integer_array = signal_col,
+        },
+        {
+            .header = "Waiter prio",
+            .type = JSON_INTEGER,
+            .integer_array = wait_col,
+        },
+    };
+
+    result_set_t set = {
+        .name = "Signal priority grid",
+        .extra_cols = extra,
+        .n_extra_cols = ARRAY_SIZE(extra),
+        .results = results,
+        .n_results = ARRAY_SIZE(results),
+    };
+    json_array_append_new(array, result_set_to_json(set));
+}
+
+/* one row for each number of producers and delay between their signals */
+static void
+process_fanin_results(signal_results_t *raw_results, ccnt_t overhead, json_t *array)
+{
+    result_desc_t desc = {
+        .ignored = N_IGNORED,
+        .overhead = overhead,
+    };
+    result_t results[N_FANIN_PRODUCERS * N_FANIN_DELAYS];
+    json_int_t producers_col[ARRAY_SIZE(results)], delay_col[ARRAY_SIZE(results)];
+    json_int_t wakeups_col[ARRAY_SIZE(results)], signals_col[ARRAY_SIZE(results)];
+    double ratio_col[ARRAY_SIZE(results)], throughput_col[ARRAY_SIZE(results)];
+
+    int row = 0;
+    for (int i = 0; i < N_FANIN_PRODUCERS; i++) {
+        for (int j = 0; j < N_FANIN_DELAYS; j++) {
+            fanin_result_t *fanin = &raw_results->fanin[i][j];
+            results[row] = process_result(fanin->wakeups, fanin->latency, desc);
+            producers_col[row] = fanin_producers[i];
+            delay_col[row] = fanin_delays[j];
+            wakeups_col[row] = fanin->wakeups;
+            signals_col[row] = fanin->signals;
+            ratio_col[row] = (double) fanin->events / fanin->wakeups;
+            throughput_col[row] = (double) fanin->events * 1000000 / fanin->cycles;
+            row++;
+        }
+    }
+
+    column_t extra[] = {
+        {
+            .header = "Producers",
+            .type = JSON_INTEGER,
+            .integer_array = producers_col,
+        },
+        {
+            .header = "Delay (cycles)",
+            .type = JSON_INTEGER,
+            .integer_array = delay_col,
+        },
+        {
+            .header = "Wakeups",
+            .type = JSON_INTEGER,
+            .integer_array = wakeups_col,
+        },
+        {
+            .header = "Signals",
+            .type = JSON_INTEGER,
+            .integer_array = signals_col,
+        },
+        {
+            .header = "Events per wakeup",
+            .type = JSON_REAL,
+            .real_array = ratio_col,
+        },
+        {
+            .header = "Events per Mcycle",
+            .type = JSON_REAL,
+            .real_array = throughput_col,
+        },
+    };
+
+    result_set_t set = {
+        .name = "Notification fan-in wakeup latency",
+        .extra_cols = extra,
+        .n_extra_cols = ARRAY_SIZE(extra),
+        .results = results,
+        .n_results = ARRAY_SIZE(results),
+    };
+    json_array_append_new(array, result_set_to_json(set));
+}
+
+static void
+process_poll_results(signal_results_t *raw_results, json_t *array)
+{
+    result_desc_t desc = {
+        .stable = true,
+        .name = "read ccnt overhead",
+        .ignored = N_IGNORED
+    };
+    result_t overhead = process_result(N_RUNS, raw_results->ccnt_overhead, desc);
+
+    result_set_t set = {
+        .name = "Read ccnt overhead",
+        .n_results = 1,
+        .n_extra_cols = 0,
+        .results = &overhead
+    };
+    json_array_append_new(array, result_set_to_json(set));
+
+    desc.stable = false;
+    desc.overhead = overhead.min;
+
+    result_t results[2];
+    results[0] = process_result(N_RUNS, raw_results->poll_idle, desc);
+    results[1] = process_result(N_RUNS, raw_results->poll_active, desc);
+
+    char *state_col[] = { "Idle", "Active" };
+    column_t extra = {
+        .header = "Notification",
+        .type = JSON_STRING,
+        .string_array = state_col,
+    };
+
+    set = (result_set_t) {
+        .name = "Poll notification",
+        .extra_cols = &extra,
+        .n_extra_cols = 1,
+        .results = results,
+        .n_results = ARRAY_SIZE(results),
+    };
+    json_array_append_new(array, result_set_to_json(set));
+}
+
 static json_t *
 signal_process(void *results) {
     signal_results_t *raw_results = results;
@@ -45,6 +205,16 @@ signal_process(void *results) {
     set.name = "Signal to high prio thread";
     json_array_append_new(array, result_set_to_json(set));
 
+    result = process_result(N_RUNS, raw_results->lo_prio_process_results, desc);
+    set.name = "Signal to high prio process";
+    json_array_append_new(array, result_set_to_json(set));
+
+    result = process_result(N_RUNS, raw_results->bound_results, desc);
+    set.name = "Signal to high prio thread receiving with bound notification";
+    json_array_append_new(array, result_set_to_json(set));
+
+    process_grid_results(raw_results, desc.overhead, array);
+
     result = process_result(N_RUNS, raw_results->hi_prio_results, desc);
     set.name = "Signal to low prio thread";
     json_array_append_new(array, result_set_to_json(set));
@@ -55,6 +225,15 @@ signal_process(void *results) {
     json_array_append_new(array, average_counters_to_json("Average signal to low prio thread",
                                                            average_results));
 
+    process_poll_results(raw_results, array);
+
+    /* the fan-in latency is measured between cycle counter reads, not around a signal */
+    desc.stable = true;
+    desc.overhead = 0;
+    desc.name = "read ccnt overhead";
+    result = process_result(N_RUNS, raw_results->ccnt_overhead, desc);
+    process_fanin_results(raw_results, result.min, array);
+
     return array;
 }
 
@@ -12,6 +12,8 @@
 
 #include <autoconf.h>
 #include <jansson.h>
+#include <math.h>
+#include <stdlib.h>
 #include <sel4bench/sel4bench.h>
 #include <utils/util.h>
 #include <smp.h>
@@ -22,25 +24,290 @@
 #include "printing.h"
 #include "processing.h"
 
+/* cores whose round trip is within this factor of the fastest cross-core
+ * round trip are reported as sharing a cluster */
+#define CLUSTER_THRESHOLD 1.5
+
 static int cores_collective_results;
 
+/* group cores by their cross-core round trip latency: each unassigned core starts
+ * a new cluster, which every other unassigned core close enough to it joins */
 static void
-process_smp_results_init(UNUSED vka_t *vka, simple_t *simple, UNUSED sel4utils_process_t *process)
+find_clusters(int nr_cores, result_t results[nr_cores][nr_cores], json_int_t clusters[nr_cores])
 {
-    cores_collective_results = simple_get_core_count(simple);
+    double fastest = 0;
+    json_int_t next_cluster = 0;
+
+    for (int i = 0; i < nr_cores; i++) {
+        clusters[i] = -1;
+        for (int j = 0; j < nr_cores; j++) {
+            if (i != j && (fastest == 0 || results[i][j].median < fastest)) {
+                fastest = results[i][j].median;
+            }
+        }
+    }
+
+    for (int i = 0; i < nr_cores; i++) {
+        if (clusters[i] != -1) {
+            continue;
+        }
+        clusters[i] = next_cluster++;
+        for (int j = i + 1; j < nr_cores; j++) {
+            double latency = MAX(results[i][j].median, results[j][i].median);
+            if (clusters[j] == -1 && latency <= fastest * CLUSTER_THRESHOLD) {
+                clusters[j] = clusters[i];
+            }
+        }
+    }
 }
 
 static json_t *
-process_smp_results(void *r)
+process_smp_matrix_results(smp_results_t *raw_results)
 {
-    smp_results_t *raw_results = r;
+    int nr_cores = cores_collective_results;
+    int n = nr_cores * nr_cores;
+    ccnt_t (*raw)[nr_cores][MATRIX_SAMPLES] = smp_result_array(raw_results, nr_cores, SMP_MATRIX);
+    result_t (*results)[nr_cores] = calloc(n, sizeof(result_t));
+    json_int_t *clusters = calloc(nr_cores, sizeof(json_int_t));
+    json_int_t *ping_col = calloc(n, sizeof(json_int_t));
+    json_int_t *pong_col = calloc(n, sizeof(json_int_t));
+    json_int_t *ping_cluster_col = calloc(n, sizeof(json_int_t));
+    json_int_t *pong_cluster_col = calloc(n, sizeof(json_int_t));
+    ZF_LOGF_IF(results == NULL || clusters == NULL || ping_col == NULL || pong_col == NULL ||
+               ping_cluster_col == NULL || pong_cluster_col == NULL,
+               "Failed to allocate SMP matrix results");
 
-    int n = TESTS * cores_collective_results;
+    for (int i = 0; i < nr_cores; i++) {
+        for (int j = 0; j < nr_cores; j++) {
+            result_desc_t desc = {
+                .name = "cross-core round trip",
+                .overhead = 0,
+            };
+            results[i][j] = process_result(MATRIX_SAMPLES, raw[i][j], desc);
+        }
+    }
 
-    json_int_t cycle_col[n], cores_col[n];
+    find_clusters(nr_cores, results, clusters);
     for (int i = 0; i < n; i++) {
-        cycle_col[i] = smp_benchmark_params[i / cores_collective_results].delay;
-        cores_col[i] = (i % cores_collective_results) + 1;
+        ping_col[i] = i / nr_cores;
+        pong_col[i] = i % nr_cores;
+        ping_cluster_col[i] = clusters[i / nr_cores];
+        pong_cluster_col[i] = clusters[i % nr_cores];
+    }
+
+    column_t extra_cols[] = {
+        {
+            .header = "Ping core",
+            .type = JSON_INTEGER,
+            .integer_array = ping_col,
+        },
+        {
+            .header = "Pong core",
+            .type = JSON_INTEGER,
+            .integer_array = pong_col,
+        },
+        {
+            .header = "Ping cluster",
+            .type = JSON_INTEGER,
+            .integer_array = ping_cluster_col,
+        },
+        {
+            .header = "Pong cluster",
+            .type = JSON_INTEGER,
+            .integer_array = pong_cluster_col,
+        },
+    };
+
+    result_set_t result_set = {
+        .name = "SMP cross-core IPC round trip",
+        .extra_cols = extra_cols,
+        .n_extra_cols = ARRAY_SIZE(extra_cols),
+        .results = (result_t *) results,
+        .n_results = n,
+    };
+
+    json_t *json = result_set_to_json(result_set);
+    free(results);
+    free(clusters);
+    free(ping_col);
+    free(pong_col);
+    free(ping_cluster_col);
+    free(pong_cluster_col);
+    return json;
+}
+
+/* round trip of a cache line between each pair of different cores, in the format
+ * of the cross-core IPC matrix, as a hardware floor for the kernel numbers */
+static json_t *
+process_smp_cache_line_results(smp_results_t *raw_results)
+{
+    int nr_cores = cores_collective_results;
+    int n = nr_cores * (nr_cores - 1);
+    ccnt_t (*raw)[nr_cores][CACHE_LINE_SAMPLES] = smp_result_array(raw_results, nr_cores, SMP_CACHE_LINE);
+    result_t *results = calloc(MAX(n, 1), sizeof(result_t));
+    json_int_t *ping_col = calloc(MAX(n, 1), sizeof(json_int_t));
+    json_int_t *pong_col = calloc(MAX(n, 1), sizeof(json_int_t));
+    json_int_t *line_size_col = calloc(MAX(n, 1), sizeof(json_int_t));
+    ZF_LOGF_IF(results == NULL || ping_col == NULL || pong_col == NULL || line_size_col == NULL,
+               "Failed to allocate SMP cache line results");
+
+    int row = 0;
+    for (int i = 0; i < nr_cores; i++) {
+        for (int j = 0; j < nr_cores; j++) {
+            if (i == j) {
+                continue;
+            }
+            result_desc_t desc = {
+                .name = "cache line round trip",
+                .overhead = 0,
+            };
+            results[row] = process_result(CACHE_LINE_SAMPLES, raw[i][j], desc);
+            ping_col[row] = i;
+            pong_col[row] = j;
+            line_size_col[row] = raw_results->cache_line_size;
+            row++;
+        }
+    }
+
+    column_t extra_cols[] = {
+        {
+            .header = "Ping core",
+            .type = JSON_INTEGER,
+            .integer_array = ping_col,
+        },
+        {
+            .header = "Pong core",
+            .type = JSON_INTEGER,
+            .integer_array = pong_col,
+        },
+        {
+            .header = "Line size",
+            .type = JSON_INTEGER,
+            .integer_array = line_size_col,
+        },
+    };
+
+    result_set_t result_set = {
+        .name = "SMP cross-core cache line round trip",
+        .extra_cols = extra_cols,
+        .n_extra_cols = ARRAY_SIZE(extra_cols),
+        .results = results,
+        .n_results = row,
+    };
+
+    json_t *json = result_set_to_json(result_set);
+    free(results);
+    free(ping_col);
+    free(pong_col);
+    free(line_size_col);
+    return json;
+}
+
+/* Jain's fairness index of the mean calls completed by each core: 1 when every core
+ * completes the same number of calls, 1/n when a single core completes all of them */
+static double
+fairness_index(int nr_cores, result_t per_core[nr_cores])
+{
+    double sum = 0, sum_squares = 0;
+
+    for (int i = 0; i < nr_cores; i++) {
+        sum += per_core[i].mean;
+        sum_squares += per_core[i].mean * per_core[i].mean;
+    }
+
+    return sum_squares == 0 ? 0 : (sum * sum) / (nr_cores * sum_squares);
+}
+
+static double
+hist_bucket_middle(int bucket)
+{
+    return hist_bucket_start(bucket) + (hist_bucket_width(bucket) - 1) / 2.0;
+}
+
+static double
+hist_quantile(uint32_t counts[HIST_BUCKETS], uint64_t total, double quantile)
+{
+    uint64_t rank = quantile * (total - 1);
+    uint64_t seen = 0;
+
+    for (int i = 0; i < HIST_BUCKETS; i++) {
+        seen += counts[i];
+        if (seen > rank) {
+            return hist_bucket_middle(i);
+        }
+    }
+
+    return 0;
+}
+
+/* summarise a latency histogram, taking each sample as the middle of its bucket */
+static result_t
+hist_result(uint32_t counts[HIST_BUCKETS])
+{
+    result_t result = {0};
+    uint64_t total = 0;
+    int first = -1, last = -1, mode = 0;
+
+    for (int i = 0; i < HIST_BUCKETS; i++) {
+        if (counts[i] == 0) {
+            continue;
+        }
+        if (first == -1) {
+            first = i;
+        }
+        last = i;
+        if (counts[i] > counts[mode]) {
+            mode = i;
+        }
+        total += counts[i];
+        result.mean += counts[i] * hist_bucket_middle(i);
+    }
+
+    if (total == 0) {
+        return result;
+    }
+
+    result.mean /= total;
+    for (int i = first; i <= last; i++) {
+        double delta = hist_bucket_middle(i) - result.mean;
+        result.variance += counts[i] * delta * delta;
+    }
+    result.variance /= total;
+    result.stddev = sqrt(result.variance);
+
+    result.min = hist_bucket_start(first);
+    result.max = hist_bucket_start(last) + hist_bucket_width(last) - 1;
+    result.mode = hist_bucket_middle(mode);
+    result.median = hist_quantile(counts, total, 0.5);
+    result.first_quantile = hist_quantile(counts, total, 0.25);
+    result.third_quantile = hist_quantile(counts, total, 0.75);
+    result.percentile_99 = hist_quantile(counts, total, 0.99);
+    result.samples = total;
+    return result;
+}
+
+/* latency of calls in the throughput benchmark, merged across the active cores. In
+ * open loop mode this is measured from the scheduled arrival of each call. */
+static json_t *
+process_smp_latency_results(smp_results_t *raw_results)
+{
+    int nr_cores = cores_collective_results;
+    int n = TESTS * nr_cores;
+    uint32_t (*histograms)[nr_cores][HIST_BUCKETS] = smp_result_array(raw_results, nr_cores,
+                                                                      SMP_LATENCY_HISTOGRAM);
+    result_t *results = calloc(n, sizeof(result_t));
+    json_int_t *cycle_col = calloc(n, sizeof(json_int_t));
+    json_int_t *cores_col = calloc(n, sizeof(json_int_t));
+    ZF_LOGF_IF(results == NULL || cycle_col == NULL || cores_col == NULL,
+               "Failed to allocate SMP latency results");
+
+    for (int i = 0; i < TESTS; i++) {
+        for (int j = 0; j < nr_cores; j++) {
+            int row = i * nr_cores + j;
+            results[row] = hist_result(histograms[i][j]);
+            cycle_col[row] = smp_benchmark_params[i].delay;
+            cores_col[row] = j + 1;
+        }
     }
 
     column_t extra_cols[] = {
@@ -56,41 +323,476 @@ process_smp_results(void *r)
         },
     };
 
-    result_t results[TESTS][cores_collective_results];
+    result_set_t result_set = {
+        .name = config_set(CONFIG_APP_SMP_OPEN_LOOP) ? "SMP Benchmark open loop latency" :
+                "SMP Benchmark call latency",
+        .extra_cols = extra_cols,
+        .n_extra_cols = ARRAY_SIZE(extra_cols),
+        .results = results,
+        .n_results = n,
+    };
+
+    json_t *json = result_set_to_json(result_set);
+    free(results);
+    free(cycle_col);
+    free(cores_col);
+    return json;
+}
+
+/* calls completed by each active core for a single test, in a set of its own to
+ * bound the memory needed to process it as the number of cores grows */
+static json_t *
+process_smp_per_core_results(smp_results_t *raw_results, int test)
+{
+    int nr_cores = cores_collective_results;
+    int n = nr_cores * (nr_cores + 1) / 2;
+    ccnt_t (*raw)[nr_cores][nr_cores][RUNS] = smp_result_array(raw_results, nr_cores,
+                                                                SMP_THROUGHPUT_PER_CORE);
+    result_t *results = calloc(n, sizeof(result_t));
+    json_int_t *cycle_col = calloc(n, sizeof(json_int_t));
+    json_int_t *cores_col = calloc(n, sizeof(json_int_t));
+    json_int_t *core_col = calloc(n, sizeof(json_int_t));
+    ZF_LOGF_IF(results == NULL || cycle_col == NULL || cores_col == NULL || core_col == NULL,
+               "Failed to allocate SMP per core results");
+
+    int row = 0;
+    for (int j = 0; j < nr_cores; j++) {
+        for (int core = 0; core <= j; core++) {
+            result_desc_t desc = {
+                .name = smp_benchmark_params[test].name,
+                .overhead = 0,
+            };
+            results[row] = process_result(RUNS, raw[test][j][core], desc);
+            cycle_col[row] = smp_benchmark_params[test].delay;
+            cores_col[row] = j + 1;
+            core_col[row] = core;
+            row++;
+        }
+    }
+
+    column_t extra_cols[] = {
+        {
+            .header = "Cycles",
+            .type = JSON_INTEGER,
+            .integer_array = cycle_col,
+        },
+        {
+            .header = "Cores",
+            .type = JSON_INTEGER,
+            .integer_array = cores_col,
+        },
+        {
+            .header = "Core",
+            .type = JSON_INTEGER,
+            .integer_array = core_col,
+        },
+    };
 
     result_set_t result_set = {
-        .name = "SMP Benchmark",
+        .name = "SMP Benchmark per core",
         .extra_cols = extra_cols,
         .n_extra_cols = ARRAY_SIZE(extra_cols),
-        .results = (result_t *) results,
+        .results = results,
         .n_results = n,
     };
 
+    json_t *json = result_set_to_json(result_set);
+    free(results);
+    free(cycle_col);
+    free(cores_col);
+    free(core_col);
+    return json;
+}
+
+static json_t *
+process_smp_wake_results(smp_results_t *raw_results)
+{
+    result_t results[WAKE_TESTS];
+    bool cross_core_col[WAKE_TESTS], busy_col[WAKE_TESTS];
+    char *priority_col[WAKE_TESTS];
+
+    for (int i = 0; i < WAKE_TESTS; i++) {
+        result_desc_t desc = {
+            .name = smp_wake_params[i].name,
+            .overhead = 0,
+        };
+        results[i] = process_result(WAKE_SAMPLES, raw_results->wake_result[i], desc);
+        cross_core_col[i] = smp_wake_params[i].cross_core;
+        busy_col[i] = smp_wake_params[i].busy;
+        priority_col[i] = smp_wake_params[i].waiter_higher ? "higher" : "lower";
+    }
+
+    column_t extra_cols[] = {
+        {
+            .header = "Cross core",
+            .type = JSON_TRUE,
+            .bool_array = cross_core_col,
+        },
+        {
+            .header = "Waiter core busy",
+            .type = JSON_TRUE,
+            .bool_array = busy_col,
+        },
+        {
+            .header = "Waiter priority",
+            .type = JSON_STRING,
+            .string_array = priority_col,
+        },
+    };
+
+    result_set_t result_set = {
+        .name = "SMP notification wake up",
+        .extra_cols = extra_cols,
+        .n_extra_cols = ARRAY_SIZE(extra_cols),
+        .results = results,
+        .n_results = WAKE_TESTS,
+    };
+
+    return result_set_to_json(result_set);
+}
+
+static json_t *
+process_smp_remote_results(smp_results_t *raw_results)
+{
+    int n = 0;
+    result_t results[NUM_REMOTE_OPS * 2];
+    char *op_col[NUM_REMOTE_OPS * 2], *measurement_col[NUM_REMOTE_OPS * 2];
+
+    for (remote_op_t op = 0; op < NUM_REMOTE_OPS; op++) {
+        result_desc_t desc = {
+            .name = smp_remote_params[op].name,
+            .overhead = 0,
+        };
+        results[n] = process_result(REMOTE_SAMPLES, raw_results->remote_invoke[op], desc);
+        op_col[n] = (char *) smp_remote_params[op].name;
+        measurement_col[n] = "invoker";
+        n++;
+        if (smp_remote_params[op].target_runs) {
+            results[n] = process_result(REMOTE_SAMPLES, raw_results->remote_run[op], desc);
+            op_col[n] = (char *) smp_remote_params[op].name;
+            measurement_col[n] = "until target runs";
+            n++;
+        }
+    }
+
+    column_t extra_cols[] = {
+        {
+            .header = "Operation",
+            .type = JSON_STRING,
+            .string_array = op_col,
+        },
+        {
+            .header = "Measured",
+            .type = JSON_STRING,
+            .string_array = measurement_col,
+        },
+    };
+
+    result_set_t result_set = {
+        .name = "SMP remote TCB operations",
+        .extra_cols = extra_cols,
+        .n_extra_cols = ARRAY_SIZE(extra_cols),
+        .results = results,
+        .n_results = n,
+    };
+
+    return result_set_to_json(result_set);
+}
+
+/* operations completed each timer period by each active core for a single operation */
+static json_t *
+process_smp_contention_ops_results(smp_results_t *raw_results, contention_op_t op)
+{
+    int nr_cores = cores_collective_results;
+    int n = nr_cores * (nr_cores + 1) / 2;
+    ccnt_t (*raw)[nr_cores][nr_cores][RUNS] = smp_result_array(raw_results, nr_cores,
+                                                                SMP_CONTENTION_OPS);
+    result_t *results = calloc(n, sizeof(result_t));
+    char **op_col = calloc(n, sizeof(char *));
+    json_int_t *cores_col = calloc(n, sizeof(json_int_t));
+    json_int_t *core_col = calloc(n, sizeof(json_int_t));
+    ZF_LOGF_IF(results == NULL || op_col == NULL || cores_col == NULL || core_col == NULL,
+               "Failed to allocate SMP contention results");
+
+    int row = 0;
+    for (int j = 0; j < nr_cores; j++) {
+        for (int core = 0; core <= j; core++) {
+            result_desc_t desc = {
+                .name = contention_op_names[op],
+                .overhead = 0,
+            };
+            results[row] = process_result(RUNS, raw[op][j][core], desc);
+            op_col[row] = (char *) contention_op_names[op];
+            cores_col[row] = j + 1;
+            core_col[row] = core;
+            row++;
+        }
+    }
+
+    column_t extra_cols[] = {
+        {
+            .header = "Operation",
+            .type = JSON_STRING,
+            .string_array = op_col,
+        },
+        {
+            .header = "Cores",
+            .type = JSON_INTEGER,
+            .integer_array = cores_col,
+        },
+        {
+            .header = "Core",
+            .type = JSON_INTEGER,
+            .integer_array = core_col,
+        },
+    };
+
+    result_set_t result_set = {
+        .name = "SMP contention operations per second",
+        .extra_cols = extra_cols,
+        .n_extra_cols = ARRAY_SIZE(extra_cols),
+        .results = results,
+        .n_results = n,
+    };
+
+    json_t *json = result_set_to_json(result_set);
+    free(results);
+    free(op_col);
+    free(cores_col);
+    free(core_col);
+    return json;
+}
+
+/* latency of individual operations in the contention benchmark, merged across the active cores */
+static json_t *
+process_smp_contention_latency_results(smp_results_t *raw_results)
+{
+    int nr_cores = cores_collective_results;
+    int n = NUM_CONTENTION_OPS * nr_cores;
+    uint32_t (*histograms)[nr_cores][HIST_BUCKETS] = smp_result_array(raw_results, nr_cores,
+                                                                      SMP_CONTENTION_HISTOGRAM);
+    result_t *results = calloc(n, sizeof(result_t));
+    char **op_col = calloc(n, sizeof(char *));
+    json_int_t *cores_col = calloc(n, sizeof(json_int_t));
+    ZF_LOGF_IF(results == NULL || op_col == NULL || cores_col == NULL,
+               "Failed to allocate SMP contention latency results");
+
+    int row = 0;
+    for (contention_op_t op = 0; op < NUM_CONTENTION_OPS; op++) {
+        if (op == CONTENTION_NULL_SYSCALL && !config_set(CONFIG_ENABLE_BENCHMARKS)) {
+            continue;
+        }
+        for (int j = 0; j < nr_cores; j++) {
+            results[row] = hist_result(histograms[op][j]);
+            op_col[row] = (char *) contention_op_names[op];
+            cores_col[row] = j + 1;
+            row++;
+        }
+    }
+
+    column_t extra_cols[] = {
+        {
+            .header = "Operation",
+            .type = JSON_STRING,
+            .string_array = op_col,
+        },
+        {
+            .header = "Cores",
+            .type = JSON_INTEGER,
+            .integer_array = cores_col,
+        },
+    };
+
+    result_set_t result_set = {
+        .name = "SMP contention latency",
+        .extra_cols = extra_cols,
+        .n_extra_cols = ARRAY_SIZE(extra_cols),
+        .results = results,
+        .n_results = row,
+    };
+
+    json_t *json = result_set_to_json(result_set);
+    free(results);
+    free(op_col);
+    free(cores_col);
+    return json;
+}
+
+/* requests served per second, or the latency of requests, for clients on every active
+ * core calling either one shared server or a server on their own core */
+static json_t *
+process_smp_server_results(smp_results_t *raw_results, bool latency)
+{
+    int nr_cores = cores_collective_results;
+    int n = NUM_SERVER_MODES * nr_cores;
+    ccnt_t (*raw)[nr_cores][RUNS] = smp_result_array(raw_results, nr_cores, SMP_SERVER_THROUGHPUT);
+    uint32_t (*histograms)[nr_cores][HIST_BUCKETS] = smp_result_array(raw_results, nr_cores,
+                                                                      SMP_SERVER_HISTOGRAM);
+    result_t *results = calloc(n, sizeof(result_t));
+    char **mode_col = calloc(n, sizeof(char *));
+    json_int_t *cores_col = calloc(n, sizeof(json_int_t));
+    ZF_LOGF_IF(results == NULL || mode_col == NULL || cores_col == NULL,
+               "Failed to allocate SMP server results");
+
+    for (server_mode_t mode = 0; mode < NUM_SERVER_MODES; mode++) {
+        for (int j = 0; j < nr_cores; j++) {
+            int row = mode * nr_cores + j;
+            if (latency) {
+                results[row] = hist_result(histograms[mode][j]);
+            } else {
+                result_desc_t desc = {
+                    .name = server_mode_names[mode],
+                    .overhead = 0,
+                };
+                results[row] = process_result(RUNS, raw[mode][j], desc);
+            }
+            mode_col[row] = (char *) server_mode_names[mode];
+            cores_col[row] = j + 1;
+        }
+    }
+
+    column_t extra_cols[] = {
+        {
+            .header = "Placement",
+            .type = JSON_STRING,
+            .string_array = mode_col,
+        },
+        {
+            .header = "Cores",
+            .type = JSON_INTEGER,
+            .integer_array = cores_col,
+        },
+    };
+
+    result_set_t result_set = {
+        .name = latency ? "SMP server placement latency" : "SMP server placement requests per second",
+        .extra_cols = extra_cols,
+        .n_extra_cols = ARRAY_SIZE(extra_cols),
+        .results = results,
+        .n_results = n,
+    };
+
+    json_t *json = result_set_to_json(result_set);
+    free(results);
+    free(mode_col);
+    free(cores_col);
+    return json;
+}
+
+static json_t *
+process_smp_results(void *r)
+{
+    smp_results_t *raw_results = r;
+    int nr_cores = cores_collective_results;
+    int n = TESTS * nr_cores;
+    ccnt_t (*raw)[nr_cores][RUNS] = smp_result_array(raw_results, nr_cores, SMP_THROUGHPUT);
+    ccnt_t (*raw_per_core)[nr_cores][nr_cores][RUNS] = smp_result_array(raw_results, nr_cores,
+                                                                         SMP_THROUGHPUT_PER_CORE);
+
+    result_t (*results)[nr_cores] = calloc(n, sizeof(result_t));
+    result_t *per_core = calloc(nr_cores, sizeof(result_t));
+    json_int_t *cycle_col = calloc(n, sizeof(json_int_t));
+    json_int_t *cores_col = calloc(n, sizeof(json_int_t));
+    double *efficiency_col = calloc(n, sizeof(double));
+    double *fairness_col = calloc(n, sizeof(double));
+    ZF_LOGF_IF(results == NULL || per_core == NULL || cycle_col == NULL || cores_col == NULL ||
+               efficiency_col == NULL || fairness_col == NULL,
+               "Failed to allocate SMP results");
+
     for (int i = 0; i < TESTS; i++) {
-        for (int j = 0; j < cores_collective_results; j++) {
+        for (int j = 0; j < nr_cores; j++) {
             result_desc_t desc = {
                 .name = smp_benchmark_params[i].name,
                 .overhead = 0,
             };
-            results[i][j] = process_result(RUNS, raw_results->benchmarks_result[i][j], desc);
+            results[i][j] = process_result(RUNS, raw[i][j], desc);
+
+            for (int core = 0; core <= j; core++) {
+                per_core[core] = calculate_results(RUNS, raw_per_core[i][j][core]);
+            }
+
+            int row = i * nr_cores + j;
+            cycle_col[row] = smp_benchmark_params[i].delay;
+            cores_col[row] = j + 1;
+            efficiency_col[row] = results[i][0].mean == 0 ? 0 :
+                                  results[i][j].mean / ((j + 1) * results[i][0].mean);
+            fairness_col[row] = fairness_index(j + 1, per_core);
         }
     }
 
+    column_t extra_cols[] = {
+        {
+            .header = "Cycles",
+            .type = JSON_INTEGER,
+            .integer_array = cycle_col,
+        },
+        {
+            .header = "Cores",
+            .type = JSON_INTEGER,
+            .integer_array = cores_col,
+        },
+        {
+            .header = "Scaling efficiency",
+            .type = JSON_REAL,
+            .real_array = efficiency_col,
+        },
+        {
+            .header = "Fairness",
+            .type = JSON_REAL,
+            .real_array = fairness_col,
+        },
+    };
+
+    result_set_t result_set = {
+        .name = "SMP Benchmark",
+        .extra_cols = extra_cols,
+        .n_extra_cols = ARRAY_SIZE(extra_cols),
+        .results = (result_t *) results,
+        .n_results = n,
+    };
+
     json_t *array = json_array();
     json_array_append_new(array, result_set_to_json(result_set));
+    free(results);
+    free(per_core);
+    free(cycle_col);
+    free(cores_col);
+    free(efficiency_col);
+    free(fairness_col);
+
+    for (int i = 0; i < TESTS; i++) {
+        json_array_append_new(array, process_smp_per_core_results(raw_results, i));
+    }
+    json_array_append_new(array, process_smp_latency_results(raw_results));
+    for (contention_op_t op = 0; op < NUM_CONTENTION_OPS; op++) {
+        if (op == CONTENTION_NULL_SYSCALL && !config_set(CONFIG_ENABLE_BENCHMARKS)) {
+            continue;
+        }
+        json_array_append_new(array, process_smp_contention_ops_results(raw_results, op));
+    }
+    json_array_append_new(array, process_smp_contention_latency_results(raw_results));
+    json_array_append_new(array, process_smp_server_results(raw_results, false));
+    json_array_append_new(array, process_smp_server_results(raw_results, true));
+    json_array_append_new(array, process_smp_matrix_results(raw_results));
+    json_array_append_new(array, process_smp_cache_line_results(raw_results));
+    json_array_append_new(array, process_smp_wake_results(raw_results));
+    json_array_append_new(array, process_smp_remote_results(raw_results));
     return array;
 }
 
 static benchmark_t smp_benchmark = {
     .name = "smp",
     .enabled = config_set(CONFIG_APP_SMPBENCH),
-    .results_pages = BYTES_TO_SIZE_BITS_PAGES(sizeof(smp_results_t), seL4_PageBits),
     .process = process_smp_results,
-    .init = process_smp_results_init
+    .init = blank_init
 };
 
 benchmark_t *
-smp_benchmark_new(void)
+smp_benchmark_new(simple_t *simple)
 {
+    /* results are dimensioned by the number of cores, so can only be sized once it is known */
+    cores_collective_results = simple_get_core_count(simple);
+    smp_benchmark.results_pages = BYTES_TO_SIZE_BITS_PAGES(smp_results_size(cores_collective_results),
+                                                           seL4_PageBits);
     return &smp_benchmark;
 }
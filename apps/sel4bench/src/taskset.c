@@ -0,0 +1,112 @@
+/*
+ * Copyright 2017, Data61
+ * Commonwealth Scientific and Industrial Research Organisation (CSIRO)
+ * ABN 41 687 119 230.
+ *
+ * This software may be distributed and modified according to the terms of
+ * the GNU General Public License version 2. Note that NO WARRANTY is provided.
+ * See "LICENSE_GPLv2.txt" for details.
+ *
+ * @TAG(DATA61_GPL)
+ */
+#include <autoconf.h>
+#include <jansson.h>
+#include <sel4bench/sel4bench.h>
+#include <utils/util.h>
+#include <taskset.h>
+
+#include "benchmark.h"
+#include "json.h"
+#include "processing.h"
+
+/* one row per task, with the response time of every job as the raw data so the
+ * distribution can be compared to the analysed worst case */
+static json_t *
+taskset_process(void *r)
+{
+    taskset_results_t *raw_results = r;
+    json_t *array = json_array();
+
+    result_t results[N_TASKS];
+    json_int_t prio_col[N_TASKS], period_col[N_TASKS], budget_col[N_TASKS], spin_col[N_TASKS];
+    json_int_t deadline_col[N_TASKS], jobs_col[N_TASKS], missed_col[N_TASKS];
+
+    for (int i = 0; i < N_TASKS; i++) {
+        /* the first job of each task is released at the critical instant, so keep it */
+        result_desc_t desc = {
+            .ignored = 0,
+            .overhead = 0,
+        };
+        results[i] = process_result(raw_results->jobs[i], raw_results->response[i], desc);
+        prio_col[i] = taskset_tasks[i].prio;
+        period_col[i] = taskset_tasks[i].period;
+        budget_col[i] = taskset_tasks[i].budget;
+        spin_col[i] = taskset_tasks[i].spin;
+        deadline_col[i] = taskset_tasks[i].period * raw_results->cycles_per_us;
+        jobs_col[i] = raw_results->jobs[i];
+        missed_col[i] = raw_results->missed[i];
+    }
+
+    column_t extra_cols[] = {
+        {
+            .header = "Prio",
+            .type = JSON_INTEGER,
+            .integer_array = prio_col,
+        },
+        {
+            .header = "Period (us)",
+            .type = JSON_INTEGER,
+            .integer_array = period_col,
+        },
+        {
+            .header = "Budget (us)",
+            .type = JSON_INTEGER,
+            .integer_array = budget_col,
+        },
+        {
+            .header = "Spin (us)",
+            .type = JSON_INTEGER,
+            .integer_array = spin_col,
+        },
+        {
+            .header = "Deadline (cycles)",
+            .type = JSON_INTEGER,
+            .integer_array = deadline_col,
+        },
+        {
+            .header = "Jobs",
+            .type = JSON_INTEGER,
+            .integer_array = jobs_col,
+        },
+        {
+            .header = "Deadline misses",
+            .type = JSON_INTEGER,
+            .integer_array = missed_col,
+        },
+    };
+
+    result_set_t set = {
+        .name = "Task set response time (cycles)",
+        .extra_cols = extra_cols,
+        .n_extra_cols = ARRAY_SIZE(extra_cols),
+        .results = results,
+        .n_results = N_TASKS,
+    };
+    json_array_append_new(array, result_set_to_json(set));
+
+    return array;
+}
+
+static benchmark_t taskset_benchmark = {
+    .name = "taskset",
+    .enabled = config_set(CONFIG_APP_TASKSETBENCH),
+    .results_pages = BYTES_TO_SIZE_BITS_PAGES(sizeof(taskset_results_t), seL4_PageBits),
+    .process = taskset_process,
+    .init = blank_init
+};
+
+benchmark_t *
+taskset_benchmark_new(void)
+{
+    return &taskset_benchmark;
+}
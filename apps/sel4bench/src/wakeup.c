@@ -0,0 +1,153 @@
+/*
+ * Copyright 2017, Data61
+ * Commonwealth Scientific and Industrial Research Organisation (CSIRO)
+ * ABN 41 687 119 230.
+ *
+ * This software may be distributed and modified according to the terms of
+ * the GNU General Public License version 2. Note that NO WARRANTY is provided.
+ * See "LICENSE_GPLv2.txt" for details.
+ *
+ * @TAG(DATA61_GPL)
+ */
+#include <autoconf.h>
+#include <jansson.h>
+#include <sel4bench/sel4bench.h>
+#include <utils/util.h>
+#include <wakeup.h>
+
+#include "benchmark.h"
+#include "json.h"
+#include "processing.h"
+
+/* latencies are counted in buckets of this many ns, the last of which also counts
+ * every latency beyond it */
+#define HIST_BUCKET_NS 1000
+#define HIST_BUCKETS 100
+
+/* one row for each non-empty bucket of each load */
+static json_t *
+wakeup_histogram_to_json(wakeup_results_t *raw_results)
+{
+    UNUSED int error;
+    json_t *object = json_object();
+    assert(object != NULL);
+
+    error = json_object_set_new(object, "Benchmark", json_string("Periodic wake up latency histogram"));
+    assert(error == 0);
+
+    json_t *rows = json_array();
+    assert(rows != NULL);
+
+    error = json_object_set_new(object, "Results", rows);
+    assert(error == 0);
+
+    for (wakeup_load_t load = 0; load < NUM_WAKEUP_LOADS; load++) {
+        json_int_t counts[HIST_BUCKETS] = {0};
+        for (int i = 0; i < WAKEUP_SAMPLES; i++) {
+            counts[MIN(raw_results->latency[load][i] / HIST_BUCKET_NS, HIST_BUCKETS - 1)]++;
+        }
+
+        for (int i = 0; i < HIST_BUCKETS; i++) {
+            if (counts[i] == 0) {
+                continue;
+            }
+            json_t *row = json_object();
+            assert(row != NULL);
+
+            error = json_object_set_new(row, "Load", json_string(wakeup_load_names[load]));
+            assert(error == 0);
+            error = json_object_set_new(row, "From (ns)", json_integer(i * HIST_BUCKET_NS));
+            assert(error == 0);
+            /* the last bucket is open ended */
+            error = json_object_set_new(row, "To (ns)", i == HIST_BUCKETS - 1 ? json_null() :
+                                        json_integer((i + 1) * HIST_BUCKET_NS));
+            assert(error == 0);
+            error = json_object_set_new(row, "Count", json_integer(counts[i]));
+            assert(error == 0);
+
+            error = json_array_append_new(rows, row);
+            assert(error == 0);
+        }
+    }
+
+    return object;
+}
+
+static json_t *
+wakeup_process(void *r)
+{
+    wakeup_results_t *raw_results = r;
+    json_t *array = json_array();
+
+    result_desc_t desc = {
+        .ignored = N_IGNORED,
+        .name = "Timer read overhead",
+    };
+    result_t overhead = process_result(N_RUNS, raw_results->overheads, desc);
+
+    result_set_t set = {
+        .name = "Timer read overhead (ns)",
+        .n_extra_cols = 0,
+        .results = &overhead,
+        .n_results = 1,
+    };
+    json_array_append_new(array, result_set_to_json(set));
+
+    result_t results[NUM_WAKEUP_LOADS];
+    char *load_col[NUM_WAKEUP_LOADS];
+    json_int_t period_col[NUM_WAKEUP_LOADS], missed_col[NUM_WAKEUP_LOADS];
+    for (wakeup_load_t load = 0; load < NUM_WAKEUP_LOADS; load++) {
+        desc = (result_desc_t) {
+            .name = wakeup_load_names[load],
+            .overhead = 0,
+        };
+        results[load] = process_result(WAKEUP_SAMPLES, raw_results->latency[load], desc);
+        load_col[load] = (char *) wakeup_load_names[load];
+        period_col[load] = WAKEUP_PERIOD_NS;
+        missed_col[load] = raw_results->missed[load];
+    }
+
+    column_t extra_cols[] = {
+        {
+            .header = "Load",
+            .type = JSON_STRING,
+            .string_array = load_col,
+        },
+        {
+            .header = "Period (ns)",
+            .type = JSON_INTEGER,
+            .integer_array = period_col,
+        },
+        {
+            .header = "Missed periods",
+            .type = JSON_INTEGER,
+            .integer_array = missed_col,
+        },
+    };
+
+    set = (result_set_t) {
+        .name = "Periodic wake up latency (ns)",
+        .extra_cols = extra_cols,
+        .n_extra_cols = ARRAY_SIZE(extra_cols),
+        .results = results,
+        .n_results = NUM_WAKEUP_LOADS,
+    };
+    json_array_append_new(array, result_set_to_json(set));
+    json_array_append_new(array, wakeup_histogram_to_json(raw_results));
+
+    return array;
+}
+
+static benchmark_t wakeup_benchmark = {
+    .name = "wakeup",
+    .enabled = config_set(CONFIG_APP_WAKEUPBENCH),
+    .results_pages = BYTES_TO_SIZE_BITS_PAGES(sizeof(wakeup_results_t), seL4_PageBits),
+    .process = wakeup_process,
+    .init = blank_init
+};
+
+benchmark_t *
+wakeup_benchmark_new(void)
+{
+    return &wakeup_benchmark;
+}
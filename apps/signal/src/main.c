@@ -27,7 +27,15 @@
 #define N_LO_SIGNAL_ARGS 4
 #define N_HI_SIGNAL_ARGS 3
 #define N_WAIT_ARGS 3
-#define MAX_ARGS 4
+#define N_BOUND_WAIT_ARGS 4
+#define N_GRID_WAIT_ARGS 2
+#define N_GRID_SIGNAL_ARGS 6
+#define N_ACK_ARGS 1
+#define N_FANIN_PRODUCER_ARGS 3
+#define N_FANIN_CONSUMER_ARGS 4
+#define MAX_ARGS 6
+/* fan-in producers and consumer share a priority, and are scheduled round robin */
+#define FANIN_PRIO (seL4_MaxPrio - 1)
 
 typedef struct helper_thread {
     sel4utils_thread_t thread;
@@ -37,6 +45,10 @@ typedef struct helper_thread {
     seL4_Word argc;
 } helper_thread_t;
 
+/* cycle count of each fan-in producer's most recent signal, and how many it has sent */
+static volatile ccnt_t fanin_signalled[FANIN_MAX_PRODUCERS];
+static volatile seL4_Word fanin_sent[FANIN_MAX_PRODUCERS];
+
 void
 abort(void)
 {
@@ -139,6 +151,146 @@ high_prio_signal_fn(int argc, char **argv)
     seL4_Wait(ntfn, NULL);
 }
 
+/* waits for signals on its bound notification while receiving on an endpoint */
+static void
+bound_wait_fn(int argc, char **argv)
+{
+    assert(argc == N_BOUND_WAIT_ARGS);
+    seL4_CPtr ep = (seL4_CPtr) atol(argv[0]);
+    seL4_CPtr done_ep = (seL4_CPtr) atol(argv[1]);
+    volatile ccnt_t *end = (volatile ccnt_t *) atol(argv[2]);
+    seL4_CPtr reply = (seL4_CPtr) atol(argv[3]);
+
+    for (int i = 0; i < N_RUNS; i++) {
+        api_recv(ep, NULL, reply);
+        SEL4BENCH_READ_CCNT(*end);
+    }
+
+    /* signal completion */
+    seL4_Send(done_ep, seL4_MessageInfo_new(0, 0, 0, 0));
+    /* block */
+    api_recv(ep, NULL, reply);
+}
+
+static void
+grid_wait_fn(int argc, char **argv)
+{
+    assert(argc == N_GRID_WAIT_ARGS);
+    seL4_CPtr ntfn = (seL4_CPtr) atol(argv[0]);
+    volatile ccnt_t *end = (volatile ccnt_t *) atol(argv[1]);
+
+    while (1) {
+        DO_REAL_WAIT(ntfn);
+        SEL4BENCH_READ_CCNT(*end);
+    }
+}
+
+/* runs below everything else in the grid, so only signals the signaller once the
+ * waiter is blocked on the notification again */
+static void
+ack_fn(int argc, char **argv)
+{
+    assert(argc == N_ACK_ARGS);
+    seL4_CPtr ack = (seL4_CPtr) atol(argv[0]);
+
+    while (1) {
+        seL4_Signal(ack);
+    }
+}
+
+static void
+grid_signal_fn(int argc, char **argv)
+{
+    assert(argc == N_GRID_SIGNAL_ARGS);
+    seL4_CPtr ntfn = (seL4_CPtr) atol(argv[0]);
+    seL4_CPtr ack = (seL4_CPtr) atol(argv[1]);
+    volatile ccnt_t *end = (volatile ccnt_t *) atol(argv[2]);
+    ccnt_t *results = (ccnt_t *) atol(argv[3]);
+    seL4_CPtr done_ep = (seL4_CPtr) atol(argv[4]);
+    bool switches = atol(argv[5]);
+
+    for (int i = 0; i < N_RUNS; i++) {
+        ccnt_t start, local_end;
+        seL4_Wait(ack, NULL);
+        SEL4BENCH_READ_CCNT(start);
+        DO_REAL_SIGNAL(ntfn);
+        SEL4BENCH_READ_CCNT(local_end);
+        results[i] = switches ? *end - start : local_end - start;
+    }
+
+    /* signal completion */
+    seL4_Send(done_ep, seL4_MessageInfo_new(0, 0, 0, 0));
+    /* block */
+    seL4_Wait(ntfn, NULL);
+}
+
+/* spins between signals, and yields after each so the other producers, and the
+ * consumer once it is woken, run before the next */
+static void
+fanin_producer_fn(int argc, char **argv)
+{
+    assert(argc == N_FANIN_PRODUCER_ARGS);
+    seL4_CPtr ntfn = (seL4_CPtr) atol(argv[0]);
+    int producer = atol(argv[1]);
+    ccnt_t delay = atol(argv[2]);
+
+    while (1) {
+        ccnt_t start, now;
+        SEL4BENCH_READ_CCNT(start);
+        do {
+            SEL4BENCH_READ_CCNT(now);
+        } while (now - start < delay);
+
+        fanin_sent[producer]++;
+        SEL4BENCH_READ_CCNT(fanin_signalled[producer]);
+        seL4_Signal(ntfn);
+        seL4_Yield();
+    }
+}
+
+/* counts the producers whose signals each wakeup delivers, until enough events
+ * have been delivered */
+static void
+fanin_consumer_fn(int argc, char **argv)
+{
+    assert(argc == N_FANIN_CONSUMER_ARGS);
+    seL4_CPtr ntfn = (seL4_CPtr) atol(argv[0]);
+    int n_producers = atol(argv[1]);
+    fanin_result_t *result = (fanin_result_t *) atol(argv[2]);
+    seL4_CPtr done_ep = (seL4_CPtr) atol(argv[3]);
+    ccnt_t start, end;
+    seL4_Word badge;
+
+    SEL4BENCH_READ_CCNT(start);
+    while (result->events < FANIN_EVENTS) {
+        seL4_Wait(ntfn, &badge);
+        SEL4BENCH_READ_CCNT(end);
+
+        ccnt_t earliest = end;
+        for (int i = 0; i < n_producers; i++) {
+            if (badge & BIT(i)) {
+                earliest = MIN(earliest, fanin_signalled[i]);
+                result->events++;
+            }
+        }
+        result->latency[result->wakeups] = end - earliest;
+        result->wakeups++;
+    }
+    SEL4BENCH_READ_CCNT(end);
+    result->cycles = end - start;
+
+    for (int i = 0; i < n_producers; i++) {
+        result->signals += fanin_sent[i];
+    }
+
+    /* signal completion */
+    seL4_Send(done_ep, seL4_MessageInfo_new(0, 0, 0, 0));
+    /* the producers keep signalling until they are suspended */
+    while (1) {
+        seL4_Wait(ntfn, NULL);
+    }
+}
+
 static void start_threads(helper_thread_t *first, helper_thread_t *second)
 {
     UNUSED int error;
@@ -213,6 +365,253 @@ benchmark(env_t *env, seL4_CPtr ep, seL4_CPtr ntfn, signal_results_t *results)
     stop_threads(&wait, &signal);
 }
 
+/* signal to a higher prio thread in another address space, which records when it
+ * runs in a page shared with us */
+static void
+benchmark_process(env_t *env, seL4_CPtr ep, seL4_CPtr ntfn, signal_results_t *results)
+{
+    sel4utils_process_t wait;
+    helper_thread_t signal = {
+         .argc = N_LO_SIGNAL_ARGS,
+         .fn = (sel4utils_thread_entry_fn) low_prio_signal_fn,
+    };
+    char wait_args_strings[N_WAIT_ARGS][WORD_STRING_SIZE];
+    char *wait_argv[N_WAIT_ARGS];
+    seL4_CPtr remote_ep, remote_ntfn;
+    cspacepath_t path;
+    UNUSED int error;
+
+    /* allocate a page to share for the end cycle count */
+    void *end = vspace_new_pages(&env->vspace, seL4_AllRights, 1, seL4_PageBits);
+    assert(end != NULL);
+
+    benchmark_shallow_clone_process(env, &wait, seL4_MaxPrio, wait_fn, "wait process");
+    benchmark_configure_thread(env, ep, seL4_MaxPrio - 1, "signal", &signal.thread);
+
+    void *remote_end = vspace_share_mem(&env->vspace, &wait.vspace, end, 1, seL4_PageBits,
+                                        seL4_AllRights, 1);
+    assert(remote_end != NULL);
+
+    vka_cspace_make_path(&env->slab_vka, ep, &path);
+    remote_ep = sel4utils_copy_path_to_process(&wait, path);
+    assert(remote_ep != seL4_CapNull);
+
+    vka_cspace_make_path(&env->slab_vka, ntfn, &path);
+    remote_ntfn = sel4utils_copy_path_to_process(&wait, path);
+    assert(remote_ntfn != seL4_CapNull);
+
+    sel4utils_create_word_args(wait_args_strings, wait_argv, N_WAIT_ARGS, remote_ntfn, remote_ep,
+                               (seL4_Word) remote_end);
+    sel4utils_create_word_args(signal.argv_strings, signal.argv, signal.argc, ntfn,
+                               (seL4_Word) end, (seL4_Word) results->lo_prio_process_results, ep);
+
+    error = sel4utils_start_thread(&signal.thread, signal.fn, (void *) signal.argc, (void *) signal.argv, 1);
+    assert(error == seL4_NoError);
+    error = sel4utils_spawn_process(&wait, &env->slab_vka, &env->vspace, N_WAIT_ARGS, wait_argv, 1);
+    assert(error == seL4_NoError);
+
+    benchmark_wait_children(ep, "children of notification benchmark", 2);
+
+    seL4_TCB_Suspend(wait.thread.tcb.cptr);
+    seL4_TCB_Suspend(signal.thread.tcb.cptr);
+}
+
+/* signal to a higher prio thread that is receiving on an endpoint, and is woken by
+ * its bound notification */
+static void
+benchmark_bound(env_t *env, seL4_CPtr ep, signal_results_t *results)
+{
+    vka_object_t bound_ep, bound_ntfn;
+    helper_thread_t wait = {
+         .argc = N_BOUND_WAIT_ARGS,
+         .fn = (sel4utils_thread_entry_fn) bound_wait_fn,
+    };
+    helper_thread_t signal = {
+         .argc = N_LO_SIGNAL_ARGS,
+         .fn = (sel4utils_thread_entry_fn) low_prio_signal_fn,
+    };
+    ccnt_t end;
+    UNUSED int error;
+
+    error = vka_alloc_endpoint(&env->slab_vka, &bound_ep);
+    assert(error == seL4_NoError);
+    error = vka_alloc_notification(&env->slab_vka, &bound_ntfn);
+    assert(error == seL4_NoError);
+
+    benchmark_configure_thread(env, ep, seL4_MaxPrio, "bound wait", &wait.thread);
+    benchmark_configure_thread(env, ep, seL4_MaxPrio - 1, "signal", &signal.thread);
+
+    error = seL4_TCB_BindNotification(wait.thread.tcb.cptr, bound_ntfn.cptr);
+    assert(error == seL4_NoError);
+
+    sel4utils_create_word_args(wait.argv_strings, wait.argv, wait.argc, bound_ep.cptr, ep,
+                               (seL4_Word) &end, wait.thread.reply.cptr);
+    sel4utils_create_word_args(signal.argv_strings, signal.argv, signal.argc, bound_ntfn.cptr,
+                               (seL4_Word) &end, (seL4_Word) results->bound_results, ep);
+
+    start_threads(&signal, &wait);
+
+    benchmark_wait_children(ep, "children of notification benchmark", 2);
+
+    stop_threads(&signal, &wait);
+}
+
+static void
+benchmark_grid(env_t *env, seL4_CPtr ep, seL4_CPtr ntfn, signal_results_t *results)
+{
+    vka_object_t ack;
+    helper_thread_t wait = {
+         .argc = N_GRID_WAIT_ARGS,
+         .fn = (sel4utils_thread_entry_fn) grid_wait_fn,
+    };
+    helper_thread_t signal = {
+         .argc = N_GRID_SIGNAL_ARGS,
+         .fn = (sel4utils_thread_entry_fn) grid_signal_fn,
+    };
+    helper_thread_t acker = {
+         .argc = N_ACK_ARGS,
+         .fn = (sel4utils_thread_entry_fn) ack_fn,
+    };
+    ccnt_t end;
+    UNUSED int error;
+
+    error = vka_alloc_notification(&env->slab_vka, &ack);
+    assert(error == seL4_NoError);
+
+    benchmark_configure_thread(env, ep, seL4_MinPrio, "wait", &wait.thread);
+    benchmark_configure_thread(env, ep, seL4_MinPrio, "signal", &signal.thread);
+    benchmark_configure_thread(env, ep, seL4_MinPrio, "ack", &acker.thread);
+
+    sel4utils_create_word_args(wait.argv_strings, wait.argv, wait.argc, ntfn, (seL4_Word) &end);
+    sel4utils_create_word_args(acker.argv_strings, acker.argv, acker.argc, ack.cptr);
+
+    for (int i = 0; i < N_SIGNAL_PRIOS; i++) {
+        error = seL4_TCB_SetPriority(signal.thread.tcb.cptr, signal_prio(i));
+        assert(error == seL4_NoError);
+
+        for (int j = 0; j < N_SIGNAL_PRIOS; j++) {
+            if (i == j) {
+                continue;
+            }
+            error = seL4_TCB_SetPriority(wait.thread.tcb.cptr, signal_prio(j));
+            assert(error == seL4_NoError);
+
+            sel4utils_create_word_args(signal.argv_strings, signal.argv, signal.argc, ntfn, ack.cptr,
+                                       (seL4_Word) &end, (seL4_Word) results->grid_results[i][j],
+                                       ep, j > i);
+
+            start_threads(&wait, &acker);
+            error = sel4utils_start_thread(&signal.thread, signal.fn, (void *) signal.argc,
+                                           (void *) signal.argv, 1);
+            assert(error == seL4_NoError);
+
+            benchmark_wait_children(ep, "children of notification benchmark", 1);
+
+            stop_threads(&wait, &acker);
+            error = seL4_TCB_Suspend(signal.thread.tcb.cptr);
+            assert(error == seL4_NoError);
+        }
+    }
+
+    /* a lower prio waiter may not have received the last signal */
+    seL4_Poll(ntfn, NULL);
+}
+
+/* producers signal one notification, each through a cap with its own badge bit,
+ * while a consumer waits on it. Signals that arrive before the consumer runs are
+ * delivered together in one wakeup. */
+static void
+benchmark_fanin(env_t *env, seL4_CPtr ep, signal_results_t *results)
+{
+    vka_object_t ntfn;
+    static helper_thread_t producers[FANIN_MAX_PRODUCERS];
+    helper_thread_t consumer = {
+         .argc = N_FANIN_CONSUMER_ARGS,
+         .fn = (sel4utils_thread_entry_fn) fanin_consumer_fn,
+    };
+    seL4_CPtr badged[FANIN_MAX_PRODUCERS];
+    UNUSED int error;
+
+    assert(fanin_producers[N_FANIN_PRODUCERS - 1] <= FANIN_MAX_PRODUCERS);
+
+    error = vka_alloc_notification(&env->slab_vka, &ntfn);
+    assert(error == seL4_NoError);
+
+    benchmark_configure_thread(env, ep, FANIN_PRIO, "fan-in consumer", &consumer.thread);
+    for (int i = 0; i < FANIN_MAX_PRODUCERS; i++) {
+        producers[i].argc = N_FANIN_PRODUCER_ARGS;
+        producers[i].fn = (sel4utils_thread_entry_fn) fanin_producer_fn;
+        benchmark_configure_thread(env, ep, FANIN_PRIO, "fan-in producer", &producers[i].thread);
+        badged[i] = benchmark_mint_badged_cap(env, ntfn.cptr, BIT(i));
+    }
+
+    for (int i = 0; i < N_FANIN_PRODUCERS; i++) {
+        for (int j = 0; j < N_FANIN_DELAYS; j++) {
+            int n = fanin_producers[i];
+
+            sel4utils_create_word_args(consumer.argv_strings, consumer.argv, consumer.argc, ntfn.cptr,
+                                       n, (seL4_Word) &results->fanin[i][j], ep);
+            error = sel4utils_start_thread(&consumer.thread, consumer.fn, (void *) consumer.argc,
+                                           (void *) consumer.argv, 1);
+            assert(error == seL4_NoError);
+
+            for (int p = 0; p < n; p++) {
+                fanin_signalled[p] = 0;
+                fanin_sent[p] = 0;
+                sel4utils_create_word_args(producers[p].argv_strings, producers[p].argv,
+                                           producers[p].argc, badged[p], p, fanin_delays[j]);
+                error = sel4utils_start_thread(&producers[p].thread, producers[p].fn,
+                                               (void *) producers[p].argc, (void *) producers[p].argv, 1);
+                assert(error == seL4_NoError);
+            }
+
+            benchmark_wait_children(ep, "fan-in consumer", 1);
+
+            error = seL4_TCB_Suspend(consumer.thread.tcb.cptr);
+            assert(error == seL4_NoError);
+            for (int p = 0; p < n; p++) {
+                error = seL4_TCB_Suspend(producers[p].thread.tcb.cptr);
+                assert(error == seL4_NoError);
+            }
+
+            /* drop any signals sent after the consumer finished */
+            seL4_Poll(ntfn.cptr, NULL);
+        }
+    }
+}
+
+static void
+measure_poll(seL4_CPtr ntfn, signal_results_t *results)
+{
+    ccnt_t start, end;
+
+    for (int i = 0; i < N_RUNS; i++) {
+        SEL4BENCH_READ_CCNT(start);
+        seL4_Poll(ntfn, NULL);
+        SEL4BENCH_READ_CCNT(end);
+        results->poll_idle[i] = (end - start);
+    }
+
+    for (int i = 0; i < N_RUNS; i++) {
+        seL4_Signal(ntfn);
+        SEL4BENCH_READ_CCNT(start);
+        seL4_Poll(ntfn, NULL);
+        SEL4BENCH_READ_CCNT(end);
+        results->poll_active[i] = (end - start);
+    }
+}
+
+void
+measure_ccnt_overhead(ccnt_t *results)
+{
+    ccnt_t start, end;
+    for (int i = 0; i < N_RUNS; i++) {
+        SEL4BENCH_READ_CCNT(start);
+        SEL4BENCH_READ_CCNT(end);
+        results[i] = (end - start);
+    }
+}
+
 void
 measure_signal_overhead(seL4_CPtr ntfn, ccnt_t *results)
 {
@@ -233,15 +632,16 @@ main(int argc, char **argv)
     vka_object_t done_ep, ntfn;
     signal_results_t *results;
 
-    /* configure the slab allocator - we need 2 tcbs, 2 scs, 1 ntfn, 1 ep */
+    /* configure the slab allocator - we need 9 tcbs, 9 scs, 4 ntfns, 3 eps, and a
+     * tcb and sc for the fan-in consumer and each producer */
     static size_t object_freq[seL4_ObjectTypeCount] = {
-        [seL4_TCBObject] = 2,
-        [seL4_EndpointObject] = 1,
+        [seL4_TCBObject] = 10 + FANIN_MAX_PRODUCERS,
+        [seL4_EndpointObject] = 3,
 #ifdef CONFIG_KERNEL_RT
-        [seL4_SchedContextObject] = 2,
-        [seL4_ReplyObject] = 2,
+        [seL4_SchedContextObject] = 10 + FANIN_MAX_PRODUCERS,
+        [seL4_ReplyObject] = 10 + FANIN_MAX_PRODUCERS,
 #endif
-        [seL4_NotificationObject] = 1,
+        [seL4_NotificationObject] = 4,
     };
 
     env = benchmark_get_env(argc, argv, sizeof(signal_results_t), object_freq);
@@ -257,7 +657,15 @@ main(int argc, char **argv)
 
     /* measure overhead */
     measure_signal_overhead(ntfn.cptr, results->overhead);
+    measure_ccnt_overhead(results->ccnt_overhead);
+
+    measure_poll(ntfn.cptr, results);
+    benchmark_process(env, done_ep.cptr, ntfn.cptr, results);
+    benchmark_bound(env, done_ep.cptr, results);
+    benchmark_grid(env, done_ep.cptr, ntfn.cptr, results);
+    benchmark_fanin(env, done_ep.cptr, results);
 
+    /* this lowers our prio, so runs last */
     benchmark(env, done_ep.cptr, ntfn.cptr, results);
 
     /* done -> results are stored in shared memory so we can now return */
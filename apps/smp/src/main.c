@@ -11,17 +11,36 @@
  */
 
 #include <autoconf.h>
+#include <string.h>
+#include <stdlib.h>
 
 #include <sel4platsupport/timer.h>
 #include <utils/time.h>
 #include <benchmark.h>
 #include <smp.h>
+#ifdef CONFIG_ENABLE_BENCHMARKS
+#include <arch/hardware.h>
+#endif
 
 #include "rnorrexp.h"
 
 #define N_ARGS 3
 #define ZIGSEED 12345678
 
+/* standard deviation of the normal delay distribution, relative to its mean */
+#define NORMAL_DELAY_STDDEV 0.25
+/* mean number of back to back calls in a burst of the bursty delay distribution */
+#define BURST_LENGTH 16
+
+/* priorities of the wake up benchmark threads, all above the thread keeping a core busy */
+#define WAKE_LO_PRIO (seL4_MinPrio + 1)
+#define WAKE_HI_PRIO (seL4_MinPrio + 2)
+
+/* priorities of the remote TCB operation target, either side of the thread keeping its core busy */
+#define REMOTE_LO_PRIO seL4_MinPrio
+#define REMOTE_BUSY_PRIO (seL4_MinPrio + 1)
+#define REMOTE_HI_PRIO (seL4_MinPrio + 2)
+
 static double current_delay_cycle;
 static ccnt_t overhead;
 
@@ -40,7 +59,93 @@ struct _pp_threads {
     char *thread_argv[N_ARGS];
 
     per_core_data_t pp_ipcs ALIGN(CACHE_LN_SZ);
-} pp_threads[CONFIG_MAX_NUM_NODES];
+    /* latency of each call, written only by ping */
+    volatile uint32_t histogram[HIST_BUCKETS] ALIGN(CACHE_LN_SZ);
+};
+
+/* one per core, allocated once the number of cores is known */
+static struct _pp_threads *pp_threads;
+
+/* a single ping/pong pair, moved between cores to build the latency matrix */
+static struct {
+    vka_object_t ep, done;
+    sel4utils_thread_t ping, pong;
+
+    char thread_args_strings[N_ARGS][WORD_STRING_SIZE];
+    char *thread_argv[N_ARGS];
+
+    ccnt_t samples[MATRIX_SAMPLES];
+} matrix;
+
+/* a flag bounced between the matrix ping and pong threads without the kernel, to
+ * give the cost of moving a cache line between their cores */
+static struct {
+    /* ping writes odd values and pong answers with the next even value */
+    volatile uint32_t *flag;
+    ccnt_t samples[CACHE_LINE_SAMPLES];
+} cache_line;
+
+/* threads for the cross core wake up benchmark */
+static struct {
+    vka_object_t ping, pong, done;
+    sel4utils_thread_t signaller, waiter, spinner;
+
+    char thread_args_strings[N_ARGS][WORD_STRING_SIZE];
+    char *thread_argv[N_ARGS];
+
+    ccnt_t samples[WAKE_SAMPLES];
+} wake;
+
+/* target of the remote TCB operations, and a thread to keep its core busy */
+static struct {
+    vka_object_t ack;
+    sel4utils_thread_t target, spinner;
+
+    char thread_args_strings[N_ARGS][WORD_STRING_SIZE];
+    char *thread_argv[N_ARGS];
+
+    /* incremented by the invoker, copied by the target when it runs */
+    volatile uint32_t request ALIGN(CACHE_LN_SZ);
+    volatile uint32_t seen ALIGN(CACHE_LN_SZ);
+} remote;
+
+/* a thread per core running one operation in a tight loop, and the partner it calls */
+struct _contention_threads {
+    vka_object_t ep, ntfn;
+    sel4utils_thread_t thread, partner;
+
+    char thread_args_strings[N_ARGS][WORD_STRING_SIZE];
+    char *thread_argv[N_ARGS];
+    char partner_args_strings[N_ARGS][WORD_STRING_SIZE];
+    char *partner_argv[N_ARGS];
+
+    volatile uint32_t ops_completed ALIGN(CACHE_LN_SZ);
+    volatile uint32_t histogram[HIST_BUCKETS];
+};
+
+/* one per core, allocated once the number of cores is known */
+static struct _contention_threads *contention_threads;
+
+/* a client and a server on each core for the server placement benchmark. Clients
+ * call either the server of their own core or the server of core 0. */
+struct _server_threads {
+    vka_object_t ep;
+    sel4utils_thread_t client, server;
+
+    /* clients are passed a badged cap to the endpoint of their server in each mode */
+    char client_args_strings[NUM_SERVER_MODES][N_ARGS][WORD_STRING_SIZE];
+    char *client_argv[NUM_SERVER_MODES][N_ARGS];
+    char server_args_strings[N_ARGS][WORD_STRING_SIZE];
+    char *server_argv[N_ARGS];
+
+    /* requests served for this client, written by its server */
+    volatile uint32_t served ALIGN(CACHE_LN_SZ);
+    /* latency of each request, written by the client */
+    volatile uint32_t histogram[HIST_BUCKETS] ALIGN(CACHE_LN_SZ);
+};
+
+/* one per core, allocated once the number of cores is known */
+static struct _server_threads *server_threads;
 
 static inline void
 wait_for_benchmark(env_t *env)
@@ -59,19 +164,117 @@ delay_warmup_period(env_t *env)
 }
 
 static inline void
-ipc_normal_delay(int id)
+histogram_add(uint32_t sum[HIST_BUCKETS], volatile uint32_t histogram[HIST_BUCKETS])
+{
+    for (int i = 0; i < HIST_BUCKETS; i++) {
+        sum[i] += histogram[i];
+    }
+}
+
+static inline void
+histogram_sub(uint32_t sum[HIST_BUCKETS], uint32_t histogram[HIST_BUCKETS])
+{
+    for (int i = 0; i < HIST_BUCKETS; i++) {
+        sum[i] -= histogram[i];
+    }
+}
+
+/* a delay drawn from the configured distribution, with a mean of 1 */
+static inline double
+ipc_delay_sample(int id)
+{
+#if defined(CONFIG_APP_SMP_DELAY_FIXED)
+    return 1.0;
+#elif defined(CONFIG_APP_SMP_DELAY_UNIFORM)
+    return 2.0 * UNI(id);
+#elif defined(CONFIG_APP_SMP_DELAY_NORMAL)
+    return MAX(0.0, 1.0 + RNOR(id) * NORMAL_DELAY_STDDEV);
+#elif defined(CONFIG_APP_SMP_DELAY_BURSTY)
+    /* each call ends the burst with probability 1 / BURST_LENGTH, and is then
+     * followed by an idle period long enough to keep the mean delay */
+    return UNI(id) < 1.0 / BURST_LENGTH ? BURST_LENGTH * REXP(id) : 0.0;
+#else
+    return REXP(id);
+#endif
+}
+
+/* spins without resetting the cycle counter, for threads that run inside the
+ * timed region of another thread on the same core */
+static inline void
+ipc_spin_no_reset(double cycles)
 {
     ccnt_t start, now, delay;
 
-    RESET_CYCLE_COUNTER;
     READ_CYCLE_COUNTER(start);
-    delay = OVERHEAD_FIXUP(REXP(id) * current_delay_cycle, overhead);
+    delay = cycles > overhead ? OVERHEAD_FIXUP(cycles, overhead) : 0;
     READ_CYCLE_COUNTER(now);
-    while (now < start + delay) {
+    while (now - start < delay) {
         READ_CYCLE_COUNTER(now);
     }
 }
 
+static inline void
+ipc_spin(double cycles)
+{
+    RESET_CYCLE_COUNTER;
+    ipc_spin_no_reset(cycles);
+}
+
+static inline void
+ipc_normal_delay(int id)
+{
+    ipc_spin(ipc_delay_sample(id) * current_delay_cycle);
+}
+
+/* the server's delay before replying, which is part of the call ping_fn times */
+static inline void
+ipc_service_delay(int id)
+{
+    ipc_spin_no_reset(ipc_delay_sample(id) * current_delay_cycle);
+}
+
+/* wait for the next scheduled arrival, given the cycles elapsed since the previous
+ * one. Returns how late the next call is issued, if the schedule is behind. */
+static inline ccnt_t
+ipc_open_loop_delay(int id, ccnt_t elapsed)
+{
+    double gap = ipc_delay_sample(id) * current_delay_cycle;
+
+    if (elapsed >= gap) {
+        return elapsed - gap;
+    }
+    ipc_spin(gap - elapsed);
+    return 0;
+}
+
+void *
+open_loop_ping_fn(int argc, char **argv, void *x)
+{
+    assert(argc == N_ARGS);
+    seL4_CPtr ep = (seL4_CPtr) atol(argv[0]);
+    int thread_id = (int) atol(argv[1]);
+    volatile uint32_t *calls_completed = &pp_threads[thread_id].pp_ipcs.calls_completed;
+    volatile uint32_t *histogram = pp_threads[thread_id].histogram;
+    ccnt_t start, end, lag, elapsed = 0;
+
+    sel4bench_init();
+    while (1) {
+        lag = ipc_open_loop_delay(thread_id, elapsed);
+
+        RESET_CYCLE_COUNTER;
+        READ_CYCLE_COUNTER(start);
+        smp_benchmark_ping(ep);
+        READ_CYCLE_COUNTER(end);
+
+        /* the call arrived lag cycles before it was issued */
+        elapsed = lag + (end - start);
+        histogram[hist_bucket(elapsed)]++;
+        (*calls_completed)++;
+    }
+
+    /* we would never return... */
+}
+
 void *
 ping_fn(int argc, char **argv, void *x)
 {
@@ -79,11 +282,18 @@ ping_fn(int argc, char **argv, void *x)
     seL4_CPtr ep = (seL4_CPtr) atol(argv[0]);
     int thread_id = (int) atol(argv[1]);
     volatile uint32_t *calls_completed = &pp_threads[thread_id].pp_ipcs.calls_completed;
+    volatile uint32_t *histogram = pp_threads[thread_id].histogram;
+    ccnt_t start, end;
 
     sel4bench_init();
     while (1) {
         ipc_normal_delay(thread_id);
+
+        RESET_CYCLE_COUNTER;
+        READ_CYCLE_COUNTER(start);
         smp_benchmark_ping(ep);
+        READ_CYCLE_COUNTER(end);
+        histogram[hist_bucket(end - start)]++;
 
         (*calls_completed)++;
     }
@@ -108,12 +318,289 @@ pong_fn(int argc, char **argv, void *x)
 
     while (1) {
         smp_benchmark_pong(ep, reply);
-        ipc_normal_delay(thread_id);
+        if (!config_set(CONFIG_APP_SMP_OPEN_LOOP)) {
+            ipc_service_delay(thread_id);
+        }
+    }
+
+    /* we would never return... */
+}
+
+void *
+matrix_ping_fn(int argc, char **argv, void *x)
+{
+    assert(argc == N_ARGS);
+    seL4_CPtr ep = (seL4_CPtr) atol(argv[0]);
+    seL4_CPtr done = (seL4_CPtr) atol(argv[1]);
+    ccnt_t start, end;
+
+    sel4bench_init();
+    for (int i = 0; i < MATRIX_WARMUPS; i++) {
+        smp_benchmark_ping(ep);
+    }
+
+    for (int i = 0; i < MATRIX_SAMPLES; i++) {
+        /* both reads happen on ping's core, so the counters of different cores are never compared */
+        RESET_CYCLE_COUNTER;
+        READ_CYCLE_COUNTER(start);
+        smp_benchmark_ping(ep);
+        READ_CYCLE_COUNTER(end);
+        matrix.samples[i] = end - start;
+    }
+
+    seL4_Signal(done);
+    /* block until suspended */
+    seL4_Wait(ep, NULL);
+
+    return NULL;
+}
+
+void *
+cache_line_ping_fn(int argc, char **argv, void *x)
+{
+    assert(argc == N_ARGS);
+    seL4_CPtr ep = (seL4_CPtr) atol(argv[0]);
+    seL4_CPtr done = (seL4_CPtr) atol(argv[1]);
+    uint32_t value = 1;
+    ccnt_t start, end;
+
+    sel4bench_init();
+    for (int i = 0; i < CACHE_LINE_WARMUPS; i++) {
+        *cache_line.flag = value;
+        while (*cache_line.flag != value + 1);
+        value += 2;
+    }
+
+    for (int i = 0; i < CACHE_LINE_SAMPLES; i++) {
+        RESET_CYCLE_COUNTER;
+        READ_CYCLE_COUNTER(start);
+        *cache_line.flag = value;
+        while (*cache_line.flag != value + 1);
+        READ_CYCLE_COUNTER(end);
+        cache_line.samples[i] = end - start;
+        value += 2;
+    }
+
+    seL4_Signal(done);
+    /* block until suspended */
+    seL4_Wait(ep, NULL);
+
+    return NULL;
+}
+
+void *
+cache_line_pong_fn(int argc, char **argv, void *x)
+{
+    while (1) {
+        uint32_t value = *cache_line.flag;
+        if (value & 1) {
+            *cache_line.flag = value + 1;
+        }
+    }
+
+    /* we would never return... */
+}
+
+void *
+server_client_fn(int argc, char **argv, void *x)
+{
+    assert(argc == N_ARGS);
+    seL4_CPtr ep = (seL4_CPtr) atol(argv[0]);
+    int id = (int) atol(argv[1]);
+    volatile uint32_t *histogram = server_threads[id].histogram;
+    ccnt_t start, end;
+
+    sel4bench_init();
+    while (1) {
+        ipc_spin(ipc_delay_sample(id) * SERVER_CLIENT_DELAY);
+
+        RESET_CYCLE_COUNTER;
+        READ_CYCLE_COUNTER(start);
+        smp_benchmark_ping(ep);
+        READ_CYCLE_COUNTER(end);
+        histogram[hist_bucket(end - start)]++;
+    }
+
+    /* we would never return... */
+}
+
+void *
+server_fn(int argc, char **argv, void *x)
+{
+    assert(argc == N_ARGS);
+    seL4_CPtr ep = (seL4_CPtr) atol(argv[0]);
+    seL4_CPtr reply = (seL4_CPtr) atol(argv[2]);
+    seL4_Word badge;
+    ccnt_t start, now;
+
+    sel4bench_init();
+    api_recv(ep, &badge, reply);
+    while (1) {
+        /* a shared server runs on the same core as a client timing its calls, so
+         * the cycle counter is not reset here */
+        READ_CYCLE_COUNTER(start);
+        do {
+            READ_CYCLE_COUNTER(now);
+        } while (now - start < SERVER_WORK);
+
+        /* the badge identifies the client served */
+        server_threads[badge - 1].served++;
+        api_reply_recv(ep, seL4_MessageInfo_new(0, 0, 0, 0), &badge, reply);
+    }
+
+    /* we would never return... */
+}
+
+void *
+matrix_pong_fn(int argc, char **argv, void *x)
+{
+    assert(argc == N_ARGS);
+    seL4_CPtr ep = (seL4_CPtr) atol(argv[0]);
+    seL4_CPtr reply = (seL4_CPtr) atol(argv[2]);
+
+    sel4bench_init();
+    api_recv(ep, NULL, reply);
+    while (1) {
+        smp_benchmark_pong(ep, reply);
+    }
+
+    /* we would never return... */
+}
+
+void *
+wake_signal_fn(int argc, char **argv, void *x)
+{
+    assert(argc == N_ARGS);
+    seL4_CPtr ping = (seL4_CPtr) atol(argv[0]);
+    seL4_CPtr pong = (seL4_CPtr) atol(argv[1]);
+    seL4_CPtr done = (seL4_CPtr) atol(argv[2]);
+    ccnt_t start, end;
+
+    sel4bench_init();
+    for (int i = 0; i < WAKE_WARMUPS + WAKE_SAMPLES; i++) {
+        /* the cycle counters of different cores cannot be compared, so halve the round trip */
+        RESET_CYCLE_COUNTER;
+        READ_CYCLE_COUNTER(start);
+        seL4_Signal(ping);
+        seL4_Wait(pong, NULL);
+        READ_CYCLE_COUNTER(end);
+        if (i >= WAKE_WARMUPS) {
+            wake.samples[i - WAKE_WARMUPS] = (end - start) / 2;
+        }
+    }
+
+    seL4_Signal(done);
+    /* block until suspended */
+    seL4_Wait(pong, NULL);
+
+    return NULL;
+}
+
+void *
+wake_wait_fn(int argc, char **argv, void *x)
+{
+    assert(argc == N_ARGS);
+    seL4_CPtr ping = (seL4_CPtr) atol(argv[0]);
+    seL4_CPtr pong = (seL4_CPtr) atol(argv[1]);
+
+    while (1) {
+        seL4_Wait(ping, NULL);
+        seL4_Signal(pong);
+    }
+
+    /* we would never return... */
+}
+
+void *
+spin_fn(int argc, char **argv, void *x)
+{
+    while (1);
+
+    /* we would never return... */
+}
+
+void *
+remote_target_fn(int argc, char **argv, void *x)
+{
+    assert(argc == N_ARGS);
+    seL4_CPtr ack = (seL4_CPtr) atol(argv[0]);
+
+    while (1) {
+        if (remote.seen != remote.request) {
+            remote.seen = remote.request;
+            seL4_Signal(ack);
+        }
     }
 
     /* we would never return... */
 }
 
+#define CONTENTION_LOOP(_data, _op) do {                                  \
+    ccnt_t start, end;                                                    \
+    while (1) {                                                           \
+        RESET_CYCLE_COUNTER;                                              \
+        READ_CYCLE_COUNTER(start);                                        \
+        _op;                                                              \
+        READ_CYCLE_COUNTER(end);                                          \
+        (_data)->histogram[hist_bucket(end - start)]++;                   \
+        (_data)->ops_completed++;                                         \
+    }                                                                     \
+} while (0)
+
+void *
+contention_fn(int argc, char **argv, void *x)
+{
+    assert(argc == N_ARGS);
+    int thread_id = (int) atol(argv[0]);
+    contention_op_t op = (contention_op_t) atol(argv[1]);
+    struct _contention_threads *data = &contention_threads[thread_id];
+    UNUSED seL4_CPtr ep = data->ep.cptr;
+    UNUSED seL4_CPtr ntfn = data->ntfn.cptr;
+
+    sel4bench_init();
+    switch (op) {
+#ifdef CONFIG_ENABLE_BENCHMARKS
+    case CONTENTION_NULL_SYSCALL:
+        CONTENTION_LOOP(data, DO_REAL_NULLSYSCALL());
+        break;
+#endif
+    case CONTENTION_SIGNAL:
+        CONTENTION_LOOP(data, seL4_Signal(ntfn));
+        break;
+    case CONTENTION_YIELD:
+        CONTENTION_LOOP(data, seL4_Yield());
+        break;
+    case CONTENTION_CALL:
+        CONTENTION_LOOP(data, smp_benchmark_ping(ep));
+        break;
+    default:
+        ZF_LOGF("Unsupported contention operation %d", op);
+    }
+
+    /* we would never return... */
+    return NULL;
+}
+
+static sched_params_t
+core_params(env_t *env, int core)
+{
+    sched_params_t params = {0};
+#ifdef CONFIG_KERNEL_RT
+    params = sched_params_round_robin(params, &env->simple, core, CONFIG_BOOT_THREAD_TIME_SLICE * US_IN_MS);
+#else
+    params.core = core;
+#endif
+    return params;
+}
+
+static void
+set_thread_core(env_t *env, sel4utils_thread_t *thread, int core)
+{
+    UNUSED int error;
+    error = sel4utils_set_sched_affinity(thread, core_params(env, core));
+    assert(!error);
+}
+
 static inline void
 benchmark_multicore_reset_test(int nr_cores)
 {
@@ -143,22 +630,29 @@ benchmark_multicore_reset_test(int nr_cores)
     }
 }
 
+/* runs one measurement window, adding the latencies of the calls made in it to histogram */
 static inline ccnt_t
-benchmark_multicore_do_ping_pong(env_t *env, int nr_cores)
+benchmark_multicore_do_ping_pong(env_t *env, int nr_cores, ccnt_t per_core[nr_cores],
+                                 uint32_t histogram[HIST_BUCKETS])
 {
     ccnt_t total = 0;
     uint32_t start[nr_cores], end[nr_cores];
+    uint32_t start_histogram[HIST_BUCKETS] = {0};
 
     delay_warmup_period(env);
     for (int i = 0; i < nr_cores; i++) {
         start[i] = pp_threads[i].pp_ipcs.calls_completed;
+        histogram_add(start_histogram, pp_threads[i].histogram);
     }
     wait_for_benchmark(env);
     for (int i = 0; i < nr_cores; i++) {
         end[i] = pp_threads[i].pp_ipcs.calls_completed;
+        histogram_add(histogram, pp_threads[i].histogram);
     }
+    histogram_sub(histogram, start_histogram);
     for (int i = 0; i < nr_cores; i++) {
-        total += (end[i] - start[i]);
+        per_core[i] = end[i] - start[i];
+        total += per_core[i];
     }
 
     return total;
@@ -168,6 +662,10 @@ static void
 benchmark_multicore_ipc_throughput(env_t *env, smp_results_t *results)
 {
     int nr_cores = simple_get_core_count(&env->simple);
+    ccnt_t (*throughput)[nr_cores][RUNS] = smp_result_array(results, nr_cores, SMP_THROUGHPUT);
+    ccnt_t (*per_core_throughput)[nr_cores][nr_cores][RUNS] = smp_result_array(results, nr_cores,
+                                                                               SMP_THROUGHPUT_PER_CORE);
+    uint32_t (*histograms)[nr_cores][HIST_BUCKETS] = smp_result_array(results, nr_cores, SMP_LATENCY_HISTOGRAM);
     int error;
 
     for (int nr_test = 0; nr_test < TESTS; nr_test++) {
@@ -191,8 +689,12 @@ benchmark_multicore_ipc_throughput(env_t *env, smp_results_t *results)
             seL4_TCB_Resume(pp_threads[core_idx].ping.tcb.cptr);
             sel4utils_checkpoint_thread(&pp_threads[core_idx].ping, &pp_threads[core_idx].ping_cp, false);
             for (int it = 0; it < RUNS; it++) {
-                results->benchmarks_result[nr_test][core_idx][it] =
-                    benchmark_multicore_do_ping_pong(env, core_idx + 1);
+                ccnt_t per_core[core_idx + 1];
+                throughput[nr_test][core_idx][it] =
+                    benchmark_multicore_do_ping_pong(env, core_idx + 1, per_core, histograms[nr_test][core_idx]);
+                for (int i = 0; i <= core_idx; i++) {
+                    per_core_throughput[nr_test][core_idx][i][it] = per_core[i];
+                }
             }
         }
 
@@ -201,6 +703,318 @@ benchmark_multicore_ipc_throughput(env_t *env, smp_results_t *results)
     }
 }
 
+static void
+benchmark_multicore_ipc_matrix(env_t *env, smp_results_t *results)
+{
+    int nr_cores = simple_get_core_count(&env->simple);
+    ccnt_t (*matrix_results)[nr_cores][MATRIX_SAMPLES] = smp_result_array(results, nr_cores, SMP_MATRIX);
+    UNUSED int error;
+
+    for (int ping_core = 0; ping_core < nr_cores; ping_core++) {
+        for (int pong_core = 0; pong_core < nr_cores; pong_core++) {
+            set_thread_core(env, &matrix.ping, ping_core);
+            set_thread_core(env, &matrix.pong, pong_core);
+
+            error = sel4utils_start_thread(&matrix.pong, (sel4utils_thread_entry_fn) matrix_pong_fn,
+                                           (void *) N_ARGS, (void *) matrix.thread_argv, 1);
+            assert(error == seL4_NoError);
+            error = sel4utils_start_thread(&matrix.ping, (sel4utils_thread_entry_fn) matrix_ping_fn,
+                                           (void *) N_ARGS, (void *) matrix.thread_argv, 1);
+            assert(error == seL4_NoError);
+
+            seL4_Wait(matrix.done.cptr, NULL);
+            seL4_TCB_Suspend(matrix.ping.tcb.cptr);
+            seL4_TCB_Suspend(matrix.pong.tcb.cptr);
+
+            memcpy(matrix_results[ping_core][pong_core], matrix.samples, sizeof(matrix.samples));
+        }
+    }
+}
+
+static void
+benchmark_multicore_cache_line(env_t *env, smp_results_t *results)
+{
+    int nr_cores = simple_get_core_count(&env->simple);
+    ccnt_t (*line_results)[nr_cores][CACHE_LINE_SAMPLES] = smp_result_array(results, nr_cores, SMP_CACHE_LINE);
+    UNUSED int error;
+
+    for (int ping_core = 0; ping_core < nr_cores; ping_core++) {
+        for (int pong_core = 0; pong_core < nr_cores; pong_core++) {
+            /* spinning threads sharing a core only switch on preemption */
+            if (ping_core == pong_core) {
+                continue;
+            }
+
+            *cache_line.flag = 0;
+            set_thread_core(env, &matrix.ping, ping_core);
+            set_thread_core(env, &matrix.pong, pong_core);
+
+            error = sel4utils_start_thread(&matrix.pong, (sel4utils_thread_entry_fn) cache_line_pong_fn,
+                                           (void *) N_ARGS, (void *) matrix.thread_argv, 1);
+            assert(error == seL4_NoError);
+            error = sel4utils_start_thread(&matrix.ping, (sel4utils_thread_entry_fn) cache_line_ping_fn,
+                                           (void *) N_ARGS, (void *) matrix.thread_argv, 1);
+            assert(error == seL4_NoError);
+
+            seL4_Wait(matrix.done.cptr, NULL);
+            seL4_TCB_Suspend(matrix.ping.tcb.cptr);
+            seL4_TCB_Suspend(matrix.pong.tcb.cptr);
+
+            memcpy(line_results[ping_core][pong_core], cache_line.samples, sizeof(cache_line.samples));
+        }
+    }
+}
+
+static void
+benchmark_multicore_wake(env_t *env, smp_results_t *results)
+{
+    UNUSED int error;
+
+    for (int nr_test = 0; nr_test < WAKE_TESTS; nr_test++) {
+        const wake_params_t *params = &smp_wake_params[nr_test];
+        int waiter_core = params->cross_core ? 1 : 0;
+
+        set_thread_core(env, &wake.signaller, 0);
+        set_thread_core(env, &wake.waiter, waiter_core);
+        set_thread_core(env, &wake.spinner, waiter_core);
+
+        error = seL4_TCB_SetPriority(wake.waiter.tcb.cptr, params->waiter_higher ? WAKE_HI_PRIO : WAKE_LO_PRIO);
+        assert(error == seL4_NoError);
+        error = seL4_TCB_SetPriority(wake.signaller.tcb.cptr, params->waiter_higher ? WAKE_LO_PRIO : WAKE_HI_PRIO);
+        assert(error == seL4_NoError);
+
+        if (params->busy) {
+            error = sel4utils_start_thread(&wake.spinner, (sel4utils_thread_entry_fn) spin_fn,
+                                           (void *) N_ARGS, (void *) wake.thread_argv, 1);
+            assert(error == seL4_NoError);
+        }
+        error = sel4utils_start_thread(&wake.waiter, (sel4utils_thread_entry_fn) wake_wait_fn,
+                                       (void *) N_ARGS, (void *) wake.thread_argv, 1);
+        assert(error == seL4_NoError);
+        error = sel4utils_start_thread(&wake.signaller, (sel4utils_thread_entry_fn) wake_signal_fn,
+                                       (void *) N_ARGS, (void *) wake.thread_argv, 1);
+        assert(error == seL4_NoError);
+
+        seL4_Wait(wake.done.cptr, NULL);
+        seL4_TCB_Suspend(wake.signaller.tcb.cptr);
+        seL4_TCB_Suspend(wake.waiter.tcb.cptr);
+        seL4_TCB_Suspend(wake.spinner.tcb.cptr);
+
+        memcpy(results->wake_result[nr_test], wake.samples, sizeof(wake.samples));
+    }
+}
+
+/* wait until the remote target has run since this was called */
+static inline void
+remote_wait_for_target(void)
+{
+    remote.request++;
+    seL4_Wait(remote.ack.cptr, NULL);
+}
+
+static void
+benchmark_multicore_remote(env_t *env, smp_results_t *results)
+{
+    int nr_cores = simple_get_core_count(&env->simple);
+    /* with only 2 cores the target has to migrate to the invoker's core */
+    sched_params_t params[] = { core_params(env, 1), core_params(env, nr_cores > 2 ? 2 : 0) };
+    ccnt_t start, end;
+    UNUSED int error;
+
+    sel4bench_init();
+
+    set_thread_core(env, &remote.target, 1);
+    error = seL4_TCB_SetPriority(remote.target.tcb.cptr, REMOTE_HI_PRIO);
+    assert(error == seL4_NoError);
+    error = sel4utils_start_thread(&remote.target, (sel4utils_thread_entry_fn) remote_target_fn,
+                                   (void *) N_ARGS, (void *) remote.thread_argv, 1);
+    assert(error == seL4_NoError);
+    remote_wait_for_target();
+
+    /* bounce the target between cores, ending on core 1 */
+    for (int i = 0; i < REMOTE_SAMPLES; i++) {
+        RESET_CYCLE_COUNTER;
+        READ_CYCLE_COUNTER(start);
+        error = sel4utils_set_sched_affinity(&remote.target, params[(i + 1) % ARRAY_SIZE(params)]);
+        READ_CYCLE_COUNTER(end);
+        assert(error == seL4_NoError);
+        results->remote_invoke[REMOTE_MIGRATE][i] = end - start;
+
+        remote_wait_for_target();
+        READ_CYCLE_COUNTER(end);
+        results->remote_run[REMOTE_MIGRATE][i] = end - start;
+    }
+
+    for (int i = 0; i < REMOTE_SAMPLES; i++) {
+        RESET_CYCLE_COUNTER;
+        READ_CYCLE_COUNTER(start);
+        error = seL4_TCB_Suspend(remote.target.tcb.cptr);
+        READ_CYCLE_COUNTER(end);
+        assert(error == seL4_NoError);
+        results->remote_invoke[REMOTE_SUSPEND][i] = end - start;
+
+        RESET_CYCLE_COUNTER;
+        READ_CYCLE_COUNTER(start);
+        error = seL4_TCB_Resume(remote.target.tcb.cptr);
+        READ_CYCLE_COUNTER(end);
+        assert(error == seL4_NoError);
+        results->remote_invoke[REMOTE_RESUME][i] = end - start;
+
+        remote_wait_for_target();
+        READ_CYCLE_COUNTER(end);
+        results->remote_run[REMOTE_RESUME][i] = end - start;
+    }
+
+    /* the target only runs on core 1 while its priority is above the spinner's */
+    set_thread_core(env, &remote.spinner, 1);
+    error = seL4_TCB_SetPriority(remote.spinner.tcb.cptr, REMOTE_BUSY_PRIO);
+    assert(error == seL4_NoError);
+    error = sel4utils_start_thread(&remote.spinner, (sel4utils_thread_entry_fn) spin_fn,
+                                   (void *) N_ARGS, (void *) remote.thread_argv, 1);
+    assert(error == seL4_NoError);
+
+    for (int i = 0; i < REMOTE_SAMPLES; i++) {
+        RESET_CYCLE_COUNTER;
+        READ_CYCLE_COUNTER(start);
+        error = seL4_TCB_SetPriority(remote.target.tcb.cptr, REMOTE_LO_PRIO);
+        READ_CYCLE_COUNTER(end);
+        assert(error == seL4_NoError);
+        results->remote_invoke[REMOTE_PRIO_LOWER][i] = end - start;
+
+        RESET_CYCLE_COUNTER;
+        READ_CYCLE_COUNTER(start);
+        error = seL4_TCB_SetPriority(remote.target.tcb.cptr, REMOTE_HI_PRIO);
+        READ_CYCLE_COUNTER(end);
+        assert(error == seL4_NoError);
+        results->remote_invoke[REMOTE_PRIO_RAISE][i] = end - start;
+
+        remote_wait_for_target();
+        READ_CYCLE_COUNTER(end);
+        results->remote_run[REMOTE_PRIO_RAISE][i] = end - start;
+    }
+
+    seL4_TCB_Suspend(remote.target.tcb.cptr);
+    seL4_TCB_Suspend(remote.spinner.tcb.cptr);
+    sel4bench_destroy();
+}
+
+static void
+benchmark_multicore_contention(env_t *env, smp_results_t *results)
+{
+    int nr_cores = simple_get_core_count(&env->simple);
+    ccnt_t (*ops)[nr_cores][nr_cores][RUNS] = smp_result_array(results, nr_cores, SMP_CONTENTION_OPS);
+    uint32_t (*histograms)[nr_cores][HIST_BUCKETS] = smp_result_array(results, nr_cores, SMP_CONTENTION_HISTOGRAM);
+    UNUSED int error;
+
+    for (contention_op_t op = 0; op < NUM_CONTENTION_OPS; op++) {
+        if (op == CONTENTION_NULL_SYSCALL && !config_set(CONFIG_ENABLE_BENCHMARKS)) {
+            continue;
+        }
+
+        for (int core_idx = 0; core_idx < nr_cores; core_idx++) {
+            int active = core_idx + 1;
+            for (int i = 0; i < active; i++) {
+                contention_threads[i].ops_completed = 0;
+                memset((void *) contention_threads[i].histogram, 0, sizeof(contention_threads[i].histogram));
+                if (op == CONTENTION_CALL) {
+                    error = sel4utils_start_thread(&contention_threads[i].partner,
+                                                   (sel4utils_thread_entry_fn) matrix_pong_fn, (void *) N_ARGS,
+                                                   (void *) contention_threads[i].partner_argv, 1);
+                    assert(error == seL4_NoError);
+                }
+                sel4utils_create_word_args(contention_threads[i].thread_args_strings,
+                                           contention_threads[i].thread_argv, N_ARGS, i, op, 0);
+                error = sel4utils_start_thread(&contention_threads[i].thread,
+                                               (sel4utils_thread_entry_fn) contention_fn, (void *) N_ARGS,
+                                               (void *) contention_threads[i].thread_argv, 1);
+                assert(error == seL4_NoError);
+            }
+
+            /* only count latencies after the warmup */
+            uint32_t start_histogram[HIST_BUCKETS] = {0};
+            delay_warmup_period(env);
+            for (int i = 0; i < active; i++) {
+                histogram_add(start_histogram, contention_threads[i].histogram);
+            }
+
+            for (int it = 0; it < RUNS; it++) {
+                uint32_t start[active];
+                for (int i = 0; i < active; i++) {
+                    start[i] = contention_threads[i].ops_completed;
+                }
+                wait_for_benchmark(env);
+                for (int i = 0; i < active; i++) {
+                    ops[op][core_idx][i][it] = contention_threads[i].ops_completed - start[i];
+                }
+            }
+
+            for (int i = 0; i < active; i++) {
+                seL4_TCB_Suspend(contention_threads[i].thread.tcb.cptr);
+                seL4_TCB_Suspend(contention_threads[i].partner.tcb.cptr);
+                histogram_add(histograms[op][core_idx], contention_threads[i].histogram);
+            }
+            histogram_sub(histograms[op][core_idx], start_histogram);
+        }
+    }
+}
+
+static void
+benchmark_multicore_server(env_t *env, smp_results_t *results)
+{
+    int nr_cores = simple_get_core_count(&env->simple);
+    ccnt_t (*throughput)[nr_cores][RUNS] = smp_result_array(results, nr_cores, SMP_SERVER_THROUGHPUT);
+    uint32_t (*histograms)[nr_cores][HIST_BUCKETS] = smp_result_array(results, nr_cores, SMP_SERVER_HISTOGRAM);
+    UNUSED int error;
+
+    for (server_mode_t mode = 0; mode < NUM_SERVER_MODES; mode++) {
+        for (int core_idx = 0; core_idx < nr_cores; core_idx++) {
+            int active = core_idx + 1;
+            int servers = mode == SERVER_SHARED ? 1 : active;
+
+            for (int i = 0; i < servers; i++) {
+                error = sel4utils_start_thread(&server_threads[i].server, (sel4utils_thread_entry_fn) server_fn,
+                                               (void *) N_ARGS, (void *) server_threads[i].server_argv, 1);
+                assert(error == seL4_NoError);
+            }
+            for (int i = 0; i < active; i++) {
+                server_threads[i].served = 0;
+                memset((void *) server_threads[i].histogram, 0, sizeof(server_threads[i].histogram));
+                error = sel4utils_start_thread(&server_threads[i].client, (sel4utils_thread_entry_fn) server_client_fn,
+                                               (void *) N_ARGS, (void *) server_threads[i].client_argv[mode], 1);
+                assert(error == seL4_NoError);
+            }
+
+            /* only count latencies after the warmup */
+            uint32_t start_histogram[HIST_BUCKETS] = {0};
+            delay_warmup_period(env);
+            for (int i = 0; i < active; i++) {
+                histogram_add(start_histogram, server_threads[i].histogram);
+            }
+
+            for (int it = 0; it < RUNS; it++) {
+                uint32_t start[active];
+                for (int i = 0; i < active; i++) {
+                    start[i] = server_threads[i].served;
+                }
+                wait_for_benchmark(env);
+                throughput[mode][core_idx][it] = 0;
+                for (int i = 0; i < active; i++) {
+                    throughput[mode][core_idx][it] += server_threads[i].served - start[i];
+                }
+            }
+
+            for (int i = 0; i < active; i++) {
+                seL4_TCB_Suspend(server_threads[i].client.tcb.cptr);
+                histogram_add(histograms[mode][core_idx], server_threads[i].histogram);
+            }
+            histogram_sub(histograms[mode][core_idx], start_histogram);
+            for (int i = 0; i < servers; i++) {
+                seL4_TCB_Suspend(server_threads[i].server.tcb.cptr);
+            }
+        }
+    }
+}
+
 int
 main(int argc, char *argv[])
 {
@@ -209,16 +1023,35 @@ main(int argc, char *argv[])
     smp_results_t *results;
     int nr_cores;
 
-    static size_t object_freq[seL4_ObjectTypeCount] = {
-        [seL4_TCBObject] = 2 * CONFIG_MAX_NUM_NODES,
-        [seL4_EndpointObject] = CONFIG_MAX_NUM_NODES,
+    /* the results and objects are sized by the number of cores, which is needed before the environment */
+    assert(argc >= 1);
+    nr_cores = ((benchmark_args_t *) atol(argv[0]))->nr_cores;
+
+    size_t object_freq[seL4_ObjectTypeCount] = {
+        [seL4_TCBObject] = 6 * nr_cores + 7,
+        [seL4_EndpointObject] = 3 * nr_cores + 1,
+        [seL4_NotificationObject] = nr_cores + 5,
     };
-    env = benchmark_get_env(argc, argv, sizeof(smp_results_t), object_freq);
+    env = benchmark_get_env(argc, argv, smp_results_size(nr_cores), object_freq);
     benchmark_init_timer(env);
     results = (smp_results_t *) env->results;
-    nr_cores = simple_get_core_count(&env->simple);
+    assert(nr_cores == simple_get_core_count(&env->simple));
     overhead = smp_benchmark_check_overhead();
 
+    pp_threads = vspace_new_pages(&env->vspace, seL4_AllRights,
+                                  BYTES_TO_SIZE_BITS_PAGES(nr_cores * sizeof(*pp_threads), seL4_PageBits),
+                                  seL4_PageBits);
+    ZF_LOGF_IF(pp_threads == NULL, "Failed to allocate ping pong threads");
+    contention_threads = vspace_new_pages(&env->vspace, seL4_AllRights,
+                                          BYTES_TO_SIZE_BITS_PAGES(nr_cores * sizeof(*contention_threads),
+                                                                   seL4_PageBits),
+                                          seL4_PageBits);
+    ZF_LOGF_IF(contention_threads == NULL, "Failed to allocate contention threads");
+    server_threads = vspace_new_pages(&env->vspace, seL4_AllRights,
+                                      BYTES_TO_SIZE_BITS_PAGES(nr_cores * sizeof(*server_threads), seL4_PageBits),
+                                      seL4_PageBits);
+    ZF_LOGF_IF(server_threads == NULL, "Failed to allocate server threads");
+
     /* initialize random number generator for each core */
     for (int i = 0; i < nr_cores; i++) {
         zigset(i, ZIGSEED + i);
@@ -247,7 +1080,10 @@ main(int argc, char *argv[])
                                    pp_threads[i].ping.reply.cptr);
 
         /* prepare ping and pong threads... */
-        error = sel4utils_start_thread(&pp_threads[i].ping, (sel4utils_thread_entry_fn) ping_fn,
+        sel4utils_thread_entry_fn ping_entry = config_set(CONFIG_APP_SMP_OPEN_LOOP) ?
+                                               (sel4utils_thread_entry_fn) open_loop_ping_fn :
+                                               (sel4utils_thread_entry_fn) ping_fn;
+        error = sel4utils_start_thread(&pp_threads[i].ping, ping_entry,
                                        (void *) N_ARGS, (void *) pp_threads[i].thread_argv, 0);
         assert(error == seL4_NoError);
         error = sel4utils_start_thread(&pp_threads[i].pong, (sel4utils_thread_entry_fn) pong_fn,
@@ -255,19 +1091,92 @@ main(int argc, char *argv[])
         assert(error == seL4_NoError);
 
         /* prepare thread for pp_ipcs on different cores */
-        sched_params_t params = {0};
-#ifdef CONFIG_KERNEL_RT
-        params = sched_params_round_robin(params, &env->simple, i, CONFIG_BOOT_THREAD_TIME_SLICE * US_IN_MS);
-#else
-        params.core = i;
-#endif
+        set_thread_core(env, &pp_threads[i].ping, i);
+        set_thread_core(env, &pp_threads[i].pong, i);
 
-        error = sel4utils_set_sched_affinity(&pp_threads[i].ping, params);
-        assert(!error);
-        error = sel4utils_set_sched_affinity(&pp_threads[i].pong, params);
-        assert(!error);
+        /* create the contention thread and its partner for each core */
+        snprintf(ping, name_sz, "cont-%i", i);
+        snprintf(pong, name_sz, "part-%i", i);
+        benchmark_configure_thread(env, 0, seL4_MinPrio, ping, &contention_threads[i].thread);
+        benchmark_configure_thread(env, 0, seL4_MinPrio, pong, &contention_threads[i].partner);
+        error = vka_alloc_endpoint(&env->slab_vka, &contention_threads[i].ep);
+        assert(error == seL4_NoError);
+        error = vka_alloc_notification(&env->slab_vka, &contention_threads[i].ntfn);
+        assert(error == seL4_NoError);
+        sel4utils_create_word_args(contention_threads[i].partner_args_strings,
+                                   contention_threads[i].partner_argv, N_ARGS, contention_threads[i].ep.cptr,
+                                   0, contention_threads[i].partner.reply.cptr);
+        set_thread_core(env, &contention_threads[i].thread, i);
+        set_thread_core(env, &contention_threads[i].partner, i);
+
+        /* create the client and server for each core. The server runs above the client, so
+         * calls from other cores are not held up by the local client spinning between calls */
+        snprintf(ping, name_sz, "clnt-%i", i);
+        snprintf(pong, name_sz, "serv-%i", i);
+        benchmark_configure_thread(env, 0, seL4_MinPrio, ping, &server_threads[i].client);
+        benchmark_configure_thread(env, 0, seL4_MinPrio + 1, pong, &server_threads[i].server);
+        error = vka_alloc_endpoint(&env->slab_vka, &server_threads[i].ep);
+        assert(error == seL4_NoError);
+        sel4utils_create_word_args(server_threads[i].server_args_strings, server_threads[i].server_argv, N_ARGS,
+                                   server_threads[i].ep.cptr, 0, server_threads[i].server.reply.cptr);
+        set_thread_core(env, &server_threads[i].client, i);
+        set_thread_core(env, &server_threads[i].server, i);
     }
 
+    /* badge each client's caps so the servers can tell them apart */
+    for (int i = 0; i < nr_cores; i++) {
+        seL4_CPtr shared = benchmark_mint_badged_cap(env, server_threads[0].ep.cptr, i + 1);
+        seL4_CPtr local = benchmark_mint_badged_cap(env, server_threads[i].ep.cptr, i + 1);
+        sel4utils_create_word_args(server_threads[i].client_args_strings[SERVER_SHARED],
+                                   server_threads[i].client_argv[SERVER_SHARED], N_ARGS, shared, i, 0);
+        sel4utils_create_word_args(server_threads[i].client_args_strings[SERVER_PER_CORE],
+                                   server_threads[i].client_argv[SERVER_PER_CORE], N_ARGS, local, i, 0);
+    }
+
+    /* create the ping/pong pair for the cross-core matrix */
+    benchmark_configure_thread(env, 0, seL4_MinPrio, "matrix-ping", &matrix.ping);
+    benchmark_configure_thread(env, 0, seL4_MinPrio, "matrix-pong", &matrix.pong);
+    error = vka_alloc_endpoint(&env->slab_vka, &matrix.ep);
+    assert(error == seL4_NoError);
+    error = vka_alloc_notification(&env->slab_vka, &matrix.done);
+    assert(error == seL4_NoError);
+    sel4utils_create_word_args(matrix.thread_args_strings, matrix.thread_argv, N_ARGS,
+                               matrix.ep.cptr, matrix.done.cptr, matrix.pong.reply.cptr);
+
+    /* give the shared flag a page of its own, so nothing else shares its cache line */
+    results->cache_line_size = smp_cache_line_size();
+    ZF_LOGF_IF(results->cache_line_size == 0 || results->cache_line_size > BIT(seL4_PageBits),
+               "Unexpected cache line size %u", results->cache_line_size);
+    cache_line.flag = vspace_new_pages(&env->vspace, seL4_AllRights, 1, seL4_PageBits);
+    ZF_LOGF_IF(cache_line.flag == NULL, "Failed to allocate shared cache line");
+
+    /* create the threads and notifications for the wake up benchmark */
+    benchmark_configure_thread(env, 0, seL4_MinPrio, "wake-signal", &wake.signaller);
+    benchmark_configure_thread(env, 0, seL4_MinPrio, "wake-wait", &wake.waiter);
+    benchmark_configure_thread(env, 0, seL4_MinPrio, "wake-spin", &wake.spinner);
+    error = vka_alloc_notification(&env->slab_vka, &wake.ping);
+    assert(error == seL4_NoError);
+    error = vka_alloc_notification(&env->slab_vka, &wake.pong);
+    assert(error == seL4_NoError);
+    error = vka_alloc_notification(&env->slab_vka, &wake.done);
+    assert(error == seL4_NoError);
+    sel4utils_create_word_args(wake.thread_args_strings, wake.thread_argv, N_ARGS,
+                               wake.ping.cptr, wake.pong.cptr, wake.done.cptr);
+
+    /* create the target of the remote TCB operations */
+    benchmark_configure_thread(env, 0, seL4_MinPrio, "remote-target", &remote.target);
+    benchmark_configure_thread(env, 0, seL4_MinPrio, "remote-spin", &remote.spinner);
+    error = vka_alloc_notification(&env->slab_vka, &remote.ack);
+    assert(error == seL4_NoError);
+    sel4utils_create_word_args(remote.thread_args_strings, remote.thread_argv, N_ARGS,
+                               remote.ack.cptr, 0, 0);
+
+    benchmark_multicore_ipc_matrix(env, results);
+    benchmark_multicore_cache_line(env, results);
+    benchmark_multicore_wake(env, results);
+    benchmark_multicore_remote(env, results);
+    benchmark_multicore_contention(env, results);
+    benchmark_multicore_server(env, results);
     benchmark_multicore_ipc_throughput(env, results);
     ZF_LOGF_IF(ltimer_reset(&env->timer.ltimer) != 0, "Failed to stop timer\n");
 
@@ -6,11 +6,12 @@
  * Combine the code below with the main program in which you want
  * normal or exponential variates.
  *
- * Then use of REXP in any expression will provide an exponential variate
- * with density exp(-x), x > 0. Before using REXP in your main, insert a
+ * Then use of RNOR in any expression will provide a standard normal variate
+ * with mean zero, variance 1, while use of REXP in any expression will provide
+ * an exponential variate with density exp(-x), x > 0. Before using REXP in your main, insert a
  * command such as 'zigset(86947731);' with your own choice of seed value > 0,
  * rather than 86947731. If you do not invoke 'zigset(...)' you will get
- * all zeros for REXP.
+ * all zeros for RNOR and REXP.
  *
  * For details of the method, see Marsaglia and Tsang, "The ziggurat method
  * for generating random variables", Journ. Statistical Software.
@@ -39,8 +40,36 @@ static struct {
 
 #define SHR3(id) (rs[id].jz = rs[id].jsr, rs[id].jsr ^= (rs[id].jsr << 13), rs[id].jsr ^= (rs[id].jsr >> 17), rs[id].jsr ^= (rs[id].jsr << 5), rs[id].jz + rs[id].jsr)
 #define UNI(id) (0.5 + (int32_t) SHR3(id) * 0.2328306e-9)
+#define RNOR(id) (rs[id].hz = SHR3(id), rs[id].iz = rs[id].hz & 127, (fabs(rs[id].hz) < rs[id].kn[rs[id].iz]) ? rs[id].hz * rs[id].wn[rs[id].iz] : nfix(id))
 #define REXP(id) (rs[id].jz = SHR3(id), rs[id].iz = rs[id].jz & 255, (rs[id].jz < rs[id].ke[rs[id].iz]) ? rs[id].jz * rs[id].we[rs[id].iz] : efix(id))
 
+static float nfix(int id)
+{
+    const float r = 3.442620f;
+    float x, y;
+
+    for ( ; ; ) {
+        x = rs[id].hz * rs[id].wn[rs[id].iz];
+        if (rs[id].iz == 0) {
+            do {
+                x = -log(UNI(id)) * 0.2904764;
+                y = -log(UNI(id));
+            } while (y + y < x * x);
+            return (rs[id].hz > 0) ? r + x : -r - x;
+        }
+
+        if (rs[id].fn[rs[id].iz] + UNI(id) * (rs[id].fn[rs[id].iz - 1] - rs[id].fn[rs[id].iz]) < exp(-0.5 * x * x)) {
+            return (x);
+        }
+
+        rs[id].hz = SHR3(id);
+        rs[id].iz = (rs[id].hz & 127);
+        if (fabs(rs[id].hz) < rs[id].kn[rs[id].iz]) {
+            return (rs[id].hz * rs[id].wn[rs[id].iz]);
+        }
+    }
+}
+
 static float efix(int id)
 {
     float x;
@@ -0,0 +1,255 @@
+/*
+ * Copyright 2017, Data61
+ * Commonwealth Scientific and Industrial Research Organisation (CSIRO)
+ * ABN 41 687 119 230.
+ *
+ * This software may be distributed and modified according to the terms of
+ * the BSD 2-Clause license. Note that NO WARRANTY is provided.
+ * See "LICENSE_BSD2.txt" for details.
+ *
+ * @TAG(DATA61_BSD)
+ */
+
+#include <autoconf.h>
+#include <stdio.h>
+
+#include <sel4platsupport/timer.h>
+#include <utils/time.h>
+
+#include <benchmark.h>
+#include <taskset.h>
+
+#define N_TASK_ARGS 4
+/* time the cycle counter is measured against the timer for */
+#define CALIBRATE_NS (100 * NS_IN_MS)
+
+/* jobs released to each task so far, and the cycle count each was released at */
+static volatile seL4_Word released[N_TASKS];
+static volatile ccnt_t release[N_TASKS][TASKSET_MAX_JOBS];
+
+static sel4utils_thread_t tasks[N_TASKS];
+static vka_object_t task_ntfns[N_TASKS];
+static char task_args_strings[N_TASKS][N_TASK_ARGS][WORD_STRING_SIZE];
+static char *task_argv[N_TASKS][N_TASK_ARGS];
+
+void
+abort(void)
+{
+    benchmark_finished(EXIT_FAILURE);
+}
+
+size_t __arch_write(char *data, int count)
+{
+    return benchmark_write(data, count);
+}
+
+/* jobs released in the window, every one of them is run */
+static seL4_Word
+task_jobs(int task)
+{
+    return (uint64_t) CONFIG_APP_TASKSET_WINDOW * US_IN_MS / taskset_tasks[task].period;
+}
+
+/* spin until this thread has executed for the given cycles, not counting the
+ * time it was preempted for */
+static void
+spin(ccnt_t cycles)
+{
+    ccnt_t prev, now, run = 0;
+
+    SEL4BENCH_READ_CCNT(prev);
+    while (run < cycles) {
+        SEL4BENCH_READ_CCNT(now);
+        if (now - prev < TASKSET_GAP_CYCLES) {
+            run += now - prev;
+        }
+        prev = now;
+    }
+}
+
+static void
+task_fn(int argc, char **argv)
+{
+    assert(argc == N_TASK_ARGS);
+    int task = atol(argv[0]);
+    seL4_CPtr ntfn = (seL4_CPtr) atol(argv[1]);
+    seL4_CPtr done_ep = (seL4_CPtr) atol(argv[2]);
+    taskset_results_t *results = (taskset_results_t *) atol(argv[3]);
+
+    ccnt_t spin_cycles = taskset_tasks[task].spin * results->cycles_per_us;
+    ccnt_t deadline = taskset_tasks[task].period * results->cycles_per_us;
+
+    for (seL4_Word job = 0; job < task_jobs(task); job++) {
+        while (released[task] <= job) {
+            seL4_Wait(ntfn, NULL);
+        }
+
+        spin(spin_cycles);
+
+        if (job < TASKSET_MAX_JOBS) {
+            ccnt_t end;
+            SEL4BENCH_READ_CCNT(end);
+            results->response[task][job] = end - release[task][job];
+            if (results->response[task][job] > deadline) {
+                results->missed[task]++;
+            }
+        }
+    }
+
+    seL4_Send(done_ep, seL4_MessageInfo_new(0, 0, 0, 0));
+    seL4_Wait(ntfn, NULL);
+}
+
+static uint64_t
+timer_now(env_t *env)
+{
+    uint64_t now;
+
+    int error = ltimer_get_time(&env->timer.ltimer, &now);
+    ZF_LOGF_IF(error, "Failed to read timer");
+    return now;
+}
+
+/* the job execution times are given in microseconds, so find how many cycles that is */
+static uint64_t
+measure_cycles_per_us(env_t *env)
+{
+    ccnt_t start_ccnt, end_ccnt;
+    uint64_t start, end;
+
+    start = timer_now(env);
+    SEL4BENCH_READ_CCNT(start_ccnt);
+    do {
+        end = timer_now(env);
+    } while (end - start < CALIBRATE_NS);
+    SEL4BENCH_READ_CCNT(end_ccnt);
+
+    return (uint64_t) (end_ccnt - start_ccnt) * NS_IN_US / (end - start);
+}
+
+/* returns straight away if time passes before the timeout is set */
+static void
+wait_until(env_t *env, uint64_t time)
+{
+    seL4_Word badge;
+
+    int error = ltimer_set_timeout(&env->timer.ltimer, time, TIMEOUT_ABSOLUTE);
+    if (error && timer_now(env) >= time) {
+        return;
+    }
+    ZF_LOGF_IF(error, "Failed to set timeout");
+
+    seL4_Wait(env->ntfn.cptr, &badge);
+    sel4platsupport_handle_timer_irq(&env->timer, badge);
+}
+
+/* release every task at the start of the window and then once a period, until
+ * the end of the window. We run above the tasks, so each release is recorded
+ * as soon as the timer wakes us. */
+static void
+run_taskset(env_t *env)
+{
+    uint64_t next[N_TASKS];
+    uint64_t start = timer_now(env) + NS_IN_MS;
+
+    for (int i = 0; i < N_TASKS; i++) {
+        next[i] = start;
+    }
+
+    while (1) {
+        uint64_t earliest = UINT64_MAX;
+        for (int i = 0; i < N_TASKS; i++) {
+            if (released[i] < task_jobs(i)) {
+                earliest = MIN(earliest, next[i]);
+            }
+        }
+        if (earliest == UINT64_MAX) {
+            break;
+        }
+
+        if (timer_now(env) < earliest) {
+            wait_until(env, earliest);
+        }
+
+        uint64_t now = timer_now(env);
+        for (int i = 0; i < N_TASKS; i++) {
+            if (released[i] < task_jobs(i) && next[i] <= now) {
+                if (released[i] < TASKSET_MAX_JOBS) {
+                    SEL4BENCH_READ_CCNT(release[i][released[i]]);
+                }
+                released[i]++;
+                seL4_Signal(task_ntfns[i].cptr);
+                next[i] += taskset_tasks[i].period * NS_IN_US;
+            }
+        }
+    }
+}
+
+int
+main(int argc, char **argv)
+{
+    env_t *env;
+    taskset_results_t *results;
+    vka_object_t done_ep = {0};
+    UNUSED int error;
+
+    static size_t object_freq[seL4_ObjectTypeCount] = {
+        [seL4_TCBObject] = N_TASKS,
+        [seL4_EndpointObject] = 1,
+        [seL4_NotificationObject] = N_TASKS,
+#ifdef CONFIG_KERNEL_RT
+        [seL4_SchedContextObject] = N_TASKS,
+        [seL4_ReplyObject] = N_TASKS,
+#endif
+    };
+
+    env = benchmark_get_env(argc, argv, sizeof(taskset_results_t), object_freq);
+    benchmark_init_timer(env);
+    results = (taskset_results_t *) env->results;
+
+    sel4bench_init();
+
+    error = vka_alloc_endpoint(&env->slab_vka, &done_ep);
+    ZF_LOGF_IF(error, "Failed to allocate endpoint");
+
+    error = ltimer_reset(&env->timer.ltimer);
+    ZF_LOGF_IF(error, "Failed to start timer");
+
+    results->cycles_per_us = measure_cycles_per_us(env);
+
+    for (int i = 0; i < N_TASKS; i++) {
+        ZF_LOGF_IF(taskset_tasks[i].prio >= seL4_MaxPrio, "Tasks must run below the benchmark");
+        results->jobs[i] = MIN(task_jobs(i), TASKSET_MAX_JOBS);
+
+        error = vka_alloc_notification(&env->slab_vka, &task_ntfns[i]);
+        ZF_LOGF_IF(error, "Failed to allocate notification");
+
+        benchmark_configure_thread(env, done_ep.cptr, taskset_tasks[i].prio, "task", &tasks[i]);
+#ifdef CONFIG_KERNEL_RT
+        error = api_sched_ctrl_configure(simple_get_sched_ctrl(&env->simple, 0),
+                                         tasks[i].sched_context.cptr,
+                                         taskset_tasks[i].budget, taskset_tasks[i].period, 0, 0);
+        ZF_LOGF_IF(error, "Failed to configure task sc");
+#endif
+
+        sel4utils_create_word_args(task_args_strings[i], task_argv[i], N_TASK_ARGS, i,
+                                   task_ntfns[i].cptr, done_ep.cptr, (seL4_Word) results);
+        error = sel4utils_start_thread(&tasks[i], (sel4utils_thread_entry_fn) task_fn,
+                                       (void *) N_TASK_ARGS, (void *) task_argv[i], true);
+        ZF_LOGF_IF(error, "Failed to start task");
+    }
+
+    run_taskset(env);
+    benchmark_wait_children(done_ep.cptr, "tasks", N_TASKS);
+
+    for (int i = 0; i < N_TASKS; i++) {
+        seL4_TCB_Suspend(tasks[i].tcb.cptr);
+    }
+
+    error = ltimer_reset(&env->timer.ltimer);
+    ZF_LOGF_IF(error, "Failed to stop timer");
+
+    /* done -> results are stored in shared memory so we can now return */
+    benchmark_finished(EXIT_SUCCESS);
+    return 0;
+}
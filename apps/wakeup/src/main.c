@@ -0,0 +1,198 @@
+/*
+ * Copyright 2017, Data61
+ * Commonwealth Scientific and Industrial Research Organisation (CSIRO)
+ * ABN 41 687 119 230.
+ *
+ * This software may be distributed and modified according to the terms of
+ * the BSD 2-Clause license. Note that NO WARRANTY is provided.
+ * See "LICENSE_BSD2.txt" for details.
+ *
+ * @TAG(DATA61_BSD)
+ */
+
+#include <autoconf.h>
+#include <stdio.h>
+
+#include <sel4platsupport/timer.h>
+#include <utils/time.h>
+
+#include <benchmark.h>
+#include <wakeup.h>
+
+#define N_LOAD_ARGS 2
+
+void
+abort(void)
+{
+    benchmark_finished(EXIT_FAILURE);
+}
+
+size_t __arch_write(char *data, int count)
+{
+    return benchmark_write(data, count);
+}
+
+static void
+spin_fn(int argc, char **argv)
+{
+    while (1);
+}
+
+static void
+ping_fn(int argc, char **argv)
+{
+    assert(argc == N_LOAD_ARGS);
+    seL4_CPtr ep = (seL4_CPtr) atol(argv[0]);
+
+    while (1) {
+        seL4_Call(ep, seL4_MessageInfo_new(0, 0, 0, 0));
+    }
+}
+
+static void
+pong_fn(int argc, char **argv)
+{
+    assert(argc == N_LOAD_ARGS);
+    seL4_CPtr ep = (seL4_CPtr) atol(argv[0]);
+    seL4_CPtr reply = (seL4_CPtr) atol(argv[1]);
+
+    api_recv(ep, NULL, reply);
+    while (1) {
+        api_reply_recv(ep, seL4_MessageInfo_new(0, 0, 0, 0), NULL, reply);
+    }
+}
+
+static uint64_t
+timer_now(env_t *env)
+{
+    uint64_t now;
+
+    int error = ltimer_get_time(&env->timer.ltimer, &now);
+    ZF_LOGF_IF(error, "Failed to read timer");
+    return now;
+}
+
+static void
+measure_overhead(env_t *env, ccnt_t results[N_RUNS])
+{
+    for (int i = 0; i < N_RUNS; i++) {
+        uint64_t start = timer_now(env);
+        uint64_t end = timer_now(env);
+        results[i] = end - start;
+    }
+}
+
+/* wait for the next programmed absolute timeout and return how late we woke up */
+static ccnt_t
+wait_for_wakeup(env_t *env, uint64_t next)
+{
+    seL4_Word badge;
+
+    int error = ltimer_set_timeout(&env->timer.ltimer, next, TIMEOUT_ABSOLUTE);
+    ZF_LOGF_IF(error, "Failed to set timeout");
+
+    seL4_Wait(env->ntfn.cptr, &badge);
+    uint64_t now = timer_now(env);
+    sel4platsupport_handle_timer_irq(&env->timer, badge);
+
+    return now > next ? now - next : 0;
+}
+
+/* wake up at the start of each period, as measured from the first, recording how
+ * late each wake up is. As cyclictest does, periods that have already started by
+ * the time we arm the next timeout are skipped rather than run back to back. The
+ * time is read again just before arming, so we do not arm a deadline that has passed. */
+static void
+measure_wakeups(env_t *env, ccnt_t results[WAKEUP_SAMPLES], ccnt_t *missed)
+{
+    uint64_t next = timer_now(env) + WAKEUP_PERIOD_NS;
+
+    *missed = 0;
+    for (int i = 0; i < WAKEUP_WARMUPS + WAKEUP_SAMPLES; i++) {
+        ccnt_t latency = wait_for_wakeup(env, next);
+        if (i >= WAKEUP_WARMUPS) {
+            results[i - WAKEUP_WARMUPS] = latency;
+        }
+
+        next += WAKEUP_PERIOD_NS;
+        uint64_t now = timer_now(env);
+        while (next <= now) {
+            next += WAKEUP_PERIOD_NS;
+            if (i >= WAKEUP_WARMUPS) {
+                (*missed)++;
+            }
+        }
+    }
+}
+
+int
+main(int argc, char **argv)
+{
+    env_t *env;
+    wakeup_results_t *results;
+    vka_object_t ep = {0};
+    sel4utils_thread_t spinner, ping, pong;
+    char strings[N_LOAD_ARGS][WORD_STRING_SIZE];
+    char *load_argv[N_LOAD_ARGS];
+    UNUSED int error;
+
+    static size_t object_freq[seL4_ObjectTypeCount] = {
+        [seL4_TCBObject] = 3,
+        [seL4_EndpointObject] = 1,
+#ifdef CONFIG_KERNEL_RT
+        [seL4_SchedContextObject] = 3,
+        [seL4_ReplyObject] = 3
+#endif
+    };
+
+    env = benchmark_get_env(argc, argv, sizeof(wakeup_results_t), object_freq);
+    benchmark_init_timer(env);
+    results = (wakeup_results_t *) env->results;
+
+    error = vka_alloc_endpoint(&env->slab_vka, &ep);
+    ZF_LOGF_IF(error, "Failed to allocate endpoint");
+
+    error = ltimer_reset(&env->timer.ltimer);
+    ZF_LOGF_IF(error, "Failed to start timer");
+
+    measure_overhead(env, results->overheads);
+
+    /* the load runs below us, so only delays our wake ups by what the kernel does for it */
+    benchmark_configure_thread(env, seL4_CapNull, seL4_MinPrio, "spinner", &spinner);
+    benchmark_configure_thread(env, seL4_CapNull, seL4_MinPrio, "ping", &ping);
+    benchmark_configure_thread(env, seL4_CapNull, seL4_MinPrio, "pong", &pong);
+    sel4utils_create_word_args(strings, load_argv, N_LOAD_ARGS, ep.cptr, pong.reply.cptr);
+
+    for (wakeup_load_t load = 0; load < NUM_WAKEUP_LOADS; load++) {
+        switch (load) {
+        case WAKEUP_LOAD_SPIN:
+            error = sel4utils_start_thread(&spinner, (sel4utils_thread_entry_fn) spin_fn,
+                                           (void *) N_LOAD_ARGS, (void *) load_argv, true);
+            assert(!error);
+            break;
+        case WAKEUP_LOAD_IPC:
+            error = sel4utils_start_thread(&pong, (sel4utils_thread_entry_fn) pong_fn,
+                                           (void *) N_LOAD_ARGS, (void *) load_argv, true);
+            assert(!error);
+            error = sel4utils_start_thread(&ping, (sel4utils_thread_entry_fn) ping_fn,
+                                           (void *) N_LOAD_ARGS, (void *) load_argv, true);
+            assert(!error);
+            break;
+        default:
+            break;
+        }
+
+        measure_wakeups(env, results->latency[load], &results->missed[load]);
+
+        seL4_TCB_Suspend(spinner.tcb.cptr);
+        seL4_TCB_Suspend(ping.tcb.cptr);
+        seL4_TCB_Suspend(pong.tcb.cptr);
+    }
+
+    error = ltimer_reset(&env->timer.ltimer);
+    ZF_LOGF_IF(error, "Failed to stop timer");
+
+    /* done -> results are stored in shared memory so we can now return */
+    benchmark_finished(EXIT_SUCCESS);
+    return 0;
+}
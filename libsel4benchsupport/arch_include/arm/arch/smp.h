@@ -44,6 +44,24 @@ smp_benchmark_pong(seL4_CPtr ep, seL4_CPtr reply)
 #endif
 }
 
+/* the smallest data cache line size, in bytes */
+static inline uint32_t
+smp_cache_line_size(void)
+{
+#ifdef CONFIG_ARCH_AARCH64
+    uint64_t ctr;
+
+    /* DminLine is the log2 of the number of words in a line */
+    asm volatile("mrs %0, ctr_el0" : "=r"(ctr));
+    return 4 << ((ctr >> 16) & 0xf);
+#elif defined(CONFIG_L1_CACHE_LINE_SIZE_BITS)
+    /* the cache type register cannot be read at user level on ARMv7 */
+    return BIT(CONFIG_L1_CACHE_LINE_SIZE_BITS);
+#else
+    return CACHE_LN_SZ;
+#endif
+}
+
 static inline ccnt_t
 smp_benchmark_check_overhead(void)
 {
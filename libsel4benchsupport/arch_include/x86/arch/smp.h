@@ -23,6 +23,16 @@
 #define RESET_CYCLE_COUNTER
 #define OVERHEAD_FIXUP(_c, _o) (_c)
 
+/* the line size cpuid reports for clflush, in bytes */
+static inline uint32_t
+smp_cache_line_size(void)
+{
+    uint32_t eax = 1, ebx, ecx = 0, edx;
+
+    asm volatile("cpuid" : "+a"(eax), "=b"(ebx), "+c"(ecx), "=d"(edx));
+    return ((ebx >> 8) & 0xff) * 8;
+}
+
 static inline ccnt_t
 smp_benchmark_check_overhead(void)
 {
@@ -114,6 +114,16 @@ void benchmark_configure_thread_in_process(env_t *env, sel4utils_process_t *proc
 void benchmark_configure_thread(env_t *env, seL4_CPtr fault_ep, uint8_t prio, char *name,
                                 sel4utils_thread_t *thread);
 
+/*
+ * Mint a copy of a cap with a badge, in a new slot of the current environment's cspace.
+ *
+ * @param env environment from benchmark_get_env
+ * @param cap the endpoint or notification cap to mint from
+ * @param badge the badge to give the new cap
+ * @return the new badged cap
+ */
+seL4_CPtr benchmark_mint_badged_cap(env_t *env, seL4_CPtr cap, seL4_Word badge);
+
 /*
  * Wait for n child threads/processes to terminate successfully.
  *
@@ -143,3 +153,21 @@ void send_result(seL4_CPtr ep, ccnt_t result);
  * @param ep The endpoint the result will be received from
  */
 ccnt_t get_result(seL4_CPtr ep);
+
+/*
+ * Send an array of counter results through given endpoint in a single message
+ *
+ * @param ep The endpoint the results will be sent through
+ * @param n The number of results to send
+ * @param results The results to be sent
+ */
+void send_results(seL4_CPtr ep, size_t n, ccnt_t results[n]);
+
+/*
+ * Receive an array of counter results, sent with send_results, from given endpoint
+ *
+ * @param ep The endpoint the results will be received from
+ * @param n The number of results to receive
+ * @param[out] results Array to write the n results to
+ */
+void get_results(seL4_CPtr ep, size_t n, ccnt_t results[n]);
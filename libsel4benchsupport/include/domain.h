@@ -0,0 +1,46 @@
+/*
+ * Copyright 2017, Data61
+ * Commonwealth Scientific and Industrial Research Organisation (CSIRO)
+ * ABN 41 687 119 230.
+ *
+ * This software may be distributed and modified according to the terms of
+ * the BSD 2-Clause license. Note that NO WARRANTY is provided.
+ * See "LICENSE_BSD2.txt" for details.
+ *
+ * @TAG(DATA61_BSD)
+ */
+#ifndef __SELBENCH_DOMAIN_H
+#define __SELBENCH_DOMAIN_H
+
+#include <sel4bench/sel4bench.h>
+#include <utils/util.h>
+
+#define N_IGNORED 10
+#define N_RUNS (100 + N_IGNORED)
+
+/* a jump in the cycle counter larger than this means the other domain ran */
+#define DOMAIN_GAP_CYCLES 10000
+/* sizes, in KiB, of the working set walked by the threads in each domain. Walks
+ * the other domain interrupts are taken again, so the largest must still be
+ * walked twice within one domain's time slice. */
+static const size_t domain_working_set_sizes[] = {32, 128, 512, 1024};
+#define N_DOMAIN_WORKING_SETS ARRAY_SIZE(domain_working_set_sizes)
+#define DOMAIN_MAX_WORKING_SET (1024 * 1024)
+/* no larger than any cache line we run on, so the walk touches every line */
+#define DOMAIN_WALK_STRIDE 32
+/* bytes walked between reads of the cycle counter, few enough lines that only a
+ * domain switch can make the gap between reads larger than DOMAIN_GAP_CYCLES */
+#define DOMAIN_WALK_CHECK 512
+
+typedef struct domain_results {
+    ccnt_t ccnt_overhead[N_RUNS];
+    /* from the last cycle count in domain 0 to the first in domain 1 */
+    ccnt_t switch_latency[N_RUNS];
+    /* walking the working set of domain 0 just after it is switched back to, indexed
+     * by domain_working_set_sizes */
+    ccnt_t cold_walk[N_DOMAIN_WORKING_SETS][N_RUNS];
+    /* walking it again straight after */
+    ccnt_t warm_walk[N_DOMAIN_WORKING_SETS][N_RUNS];
+} domain_results_t;
+
+#endif /* __SELBENCH_DOMAIN_H */
@@ -0,0 +1,54 @@
+/*
+ * Copyright 2017, Data61
+ * Commonwealth Scientific and Industrial Research Organisation (CSIRO)
+ * ABN 41 687 119 230.
+ *
+ * This software may be distributed and modified according to the terms of
+ * the BSD 2-Clause license. Note that NO WARRANTY is provided.
+ * See "LICENSE_BSD2.txt" for details.
+ *
+ * @TAG(DATA61_BSD)
+ */
+#ifndef __SELBENCH_EVENTLOOP_H
+#define __SELBENCH_EVENTLOOP_H
+
+#include <stdbool.h>
+#include <sel4bench/sel4bench.h>
+
+#define N_IGNORED 10
+#define N_RUNS (100 + N_IGNORED)
+
+/* events that wake the server, an IPC on its endpoint or a signal on its bound
+ * notification */
+enum eventloop_event {
+    EVENT_IPC,
+    EVENT_SIGNAL,
+    N_EVENT_TYPES
+};
+
+/* order the client sends events in */
+enum eventloop_mix {
+    MIX_IPC,
+    MIX_SIGNAL,
+    MIX_ALTERNATE,
+    MIX_RANDOM,
+    N_EVENTLOOP_MIXES
+};
+
+typedef struct eventloop_results {
+    ccnt_t ccnt_overhead[N_RUNS];
+    /* from the client sending an event until the server runs */
+    ccnt_t arrival[N_EVENTLOOP_MIXES][N_EVENT_TYPES][N_RUNS];
+    /* from the client sending an event until it runs again, with the server
+     * waiting for the next event */
+    ccnt_t handled[N_EVENTLOOP_MIXES][N_EVENT_TYPES][N_RUNS];
+} eventloop_results_t;
+
+static inline bool
+eventloop_mix_has(int mix, int event)
+{
+    return !(mix == MIX_IPC && event == EVENT_SIGNAL) &&
+           !(mix == MIX_SIGNAL && event == EVENT_IPC);
+}
+
+#endif /* __SELBENCH_EVENTLOOP_H */
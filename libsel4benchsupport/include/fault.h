@@ -11,10 +11,16 @@
  */
 #pragma once
 
+#include <autoconf.h>
 #include <sel4bench/sel4bench.h>
 
 #define N_IGNORED 10
 #define N_RUNS (100 + N_IGNORED)
+#ifdef CONFIG_KERNEL_RT
+/* budget of the thread that raises timeout faults, in microseconds */
+#define TIMEOUT_FAULT_BUDGET 1000
+#define TIMEOUT_FAULT_PERIOD (10 * TIMEOUT_FAULT_BUDGET)
+#endif
 
 typedef struct {
     ccnt_t reply_recv_overhead[N_RUNS];
@@ -27,4 +33,10 @@ typedef struct {
     ccnt_t round_trip[N_RUNS + 1];
     ccnt_t fault[N_RUNS + 1];
     ccnt_t fault_reply[N_RUNS + 1];
+#ifdef CONFIG_KERNEL_RT
+    /* budget expiry -> timeout fault handler */
+    ccnt_t timeout_fault[N_RUNS + 1];
+    /* timeout fault handler -> faulter, with its budget refilled */
+    ccnt_t timeout_fault_reply[N_RUNS + 1];
+#endif
 } fault_results_t;
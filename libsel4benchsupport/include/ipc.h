@@ -12,6 +12,7 @@
 #ifndef __SELBENCH_IPC_H
 #define __SELBENCH_IPC_H
 
+#include <autoconf.h>
 #include <sel4bench/sel4bench.h>
 #include <sel4utils/process.h>
 
@@ -25,6 +26,10 @@ enum overheads {
     RECV_OVERHEAD,
     CALL_10_OVERHEAD,
     REPLY_RECV_10_OVERHEAD,
+#ifdef CONFIG_KERNEL_RT
+    NBSEND_RECV_OVERHEAD,
+    NBSEND_WAIT_OVERHEAD,
+#endif
     /******/
     NUM_OVERHEAD_BENCHMARKS
 };
@@ -46,7 +51,17 @@ typedef enum {
     IPC_REPLYRECV_10_FUNC2 = 6,
     IPC_REPLYRECV_10_FUNC = 7,
     IPC_SEND_FUNC = 8,
-    IPC_RECV_FUNC = 9
+    IPC_RECV_FUNC = 9,
+#ifdef CONFIG_KERNEL_RT
+    /* server loops that reply with NBSendRecv on the reply object */
+    IPC_NBSENDRECV_FUNC2 = 10,
+    IPC_NBSENDRECV_FUNC = 11,
+    /* client and server that both send and wait with NBSendWait */
+    IPC_NBSENDWAIT_CLIENT_FUNC2 = 12,
+    IPC_NBSENDWAIT_SERVER_FUNC2 = 13,
+    IPC_NBSENDWAIT_CLIENT_FUNC = 14,
+    IPC_NBSENDWAIT_SERVER_FUNC = 15,
+#endif
 } helper_func_id_t;
 
 typedef seL4_Word (*helper_func_t)(int argc, char *argv[]);
@@ -164,9 +179,130 @@ static const benchmark_params_t benchmark_params[] = {
         .server_prio = seL4_MaxPrio - 1,
         .length = 10,
         .overhead_id = REPLY_RECV_10_OVERHEAD
-    }
+    },
+#ifdef CONFIG_KERNEL_RT
+    /* Call fastpath to an active server in a different address space, to compare
+     * against scheduling context donation to a passive server */
+    {
+        .name        = "seL4_Call",
+        .direction   = DIR_TO,
+        .client_fn   = IPC_CALL_FUNC2,
+        .server_fn   = IPC_REPLYRECV_FUNC2,
+        .same_vspace = false,
+        .client_prio = seL4_MaxPrio - 1,
+        .server_prio = seL4_MaxPrio - 1,
+        .length = 0,
+        .overhead_id = CALL_OVERHEAD,
+        .passive = false,
+    },
+    /* ReplyRecv fastpath from an active server in a different address space */
+    {
+        .name        = "seL4_ReplyRecv",
+        .direction   = DIR_FROM,
+        .client_fn   = IPC_CALL_FUNC,
+        .server_fn   = IPC_REPLYRECV_FUNC,
+        .same_vspace = false,
+        .client_prio = seL4_MaxPrio - 1,
+        .server_prio = seL4_MaxPrio - 1,
+        .length = 0,
+        .overhead_id = REPLY_RECV_OVERHEAD,
+        .passive = false,
+    },
+    /* Call to a passive server that replies with NBSendRecv, different address spaces */
+    {
+        .name        = "seL4_Call (NBSendRecv server)",
+        .direction   = DIR_TO,
+        .client_fn   = IPC_CALL_FUNC2,
+        .server_fn   = IPC_NBSENDRECV_FUNC2,
+        .same_vspace = false,
+        .client_prio = seL4_MaxPrio - 1,
+        .server_prio = seL4_MaxPrio - 1,
+        .length = 0,
+        .overhead_id = CALL_OVERHEAD,
+        .passive = true,
+    },
+    /* Call to an active server that replies with NBSendRecv, different address spaces */
+    {
+        .name        = "seL4_Call (NBSendRecv server)",
+        .direction   = DIR_TO,
+        .client_fn   = IPC_CALL_FUNC2,
+        .server_fn   = IPC_NBSENDRECV_FUNC2,
+        .same_vspace = false,
+        .client_prio = seL4_MaxPrio - 1,
+        .server_prio = seL4_MaxPrio - 1,
+        .length = 0,
+        .overhead_id = CALL_OVERHEAD,
+        .passive = false,
+    },
+    /* NBSendRecv on the reply object from a passive server, different address spaces */
+    {
+        .name        = "seL4_NBSendRecv",
+        .direction   = DIR_FROM,
+        .client_fn   = IPC_CALL_FUNC,
+        .server_fn   = IPC_NBSENDRECV_FUNC,
+        .same_vspace = false,
+        .client_prio = seL4_MaxPrio - 1,
+        .server_prio = seL4_MaxPrio - 1,
+        .length = 0,
+        .overhead_id = NBSEND_RECV_OVERHEAD,
+        .passive = true,
+    },
+    /* NBSendRecv on the reply object from an active server, different address spaces */
+    {
+        .name        = "seL4_NBSendRecv",
+        .direction   = DIR_FROM,
+        .client_fn   = IPC_CALL_FUNC,
+        .server_fn   = IPC_NBSENDRECV_FUNC,
+        .same_vspace = false,
+        .client_prio = seL4_MaxPrio - 1,
+        .server_prio = seL4_MaxPrio - 1,
+        .length = 0,
+        .overhead_id = NBSEND_RECV_OVERHEAD,
+        .passive = false,
+    },
+    /* NBSendWait between active client and server in different address spaces. Send does
+     * not donate a scheduling context, so there is no passive variant */
+    {
+        .name        = "seL4_NBSendWait",
+        .direction   = DIR_TO,
+        .client_fn   = IPC_NBSENDWAIT_CLIENT_FUNC2,
+        .server_fn   = IPC_NBSENDWAIT_SERVER_FUNC2,
+        .same_vspace = false,
+        .client_prio = seL4_MaxPrio - 1,
+        .server_prio = seL4_MaxPrio - 1,
+        .length = 0,
+        .overhead_id = NBSEND_WAIT_OVERHEAD,
+        .passive = false,
+    },
+    {
+        .name        = "seL4_NBSendWait",
+        .direction   = DIR_FROM,
+        .client_fn   = IPC_NBSENDWAIT_CLIENT_FUNC,
+        .server_fn   = IPC_NBSENDWAIT_SERVER_FUNC,
+        .same_vspace = false,
+        .client_prio = seL4_MaxPrio - 1,
+        .server_prio = seL4_MaxPrio - 1,
+        .length = 0,
+        .overhead_id = NBSEND_WAIT_OVERHEAD,
+        .passive = false,
+    },
+#endif /* CONFIG_KERNEL_RT */
 };
 
+#ifdef CONFIG_APP_IPC_COLD_CACHE
+/* sizes, in KiB, of the buffer that is touched before each measured IPC in cold cache mode */
+static const size_t pollution_sizes[] = {0, 4, 16, 64, 256, 1024};
+#define MAX_POLLUTION_SIZE (1024 * 1024)
+#endif
+
+#ifdef CONFIG_APP_IPC_ADDRESS_SPACES
+/* numbers of server processes to round robin Calls across */
+static const size_t address_space_counts[] = {1, 2, 4, 8, 16, 32, 64, 128, 256, 384, 512};
+#define MAX_ADDRESS_SPACES 512
+/* number of Calls to each server per run, the last of which is measured */
+#define ADDRESS_SPACE_ROUNDS 4
+#endif
+
 static const struct overhead_benchmark_params overhead_benchmark_params[] = {
     [CALL_OVERHEAD]          = {"call"},
     [REPLY_RECV_OVERHEAD]    = {"reply recv"},
@@ -174,12 +310,30 @@ static const struct overhead_benchmark_params overhead_benchmark_params[] = {
     [RECV_OVERHEAD]          = {"recv"},
     [CALL_10_OVERHEAD]       = {"call"},
     [REPLY_RECV_10_OVERHEAD] = {"reply recv"},
+#ifdef CONFIG_KERNEL_RT
+    [NBSEND_RECV_OVERHEAD]   = {"nbsend recv"},
+    [NBSEND_WAIT_OVERHEAD]   = {"nbsend wait"},
+#endif
 };
 
 typedef struct ipc_results {
     /* Raw results from benchmarking. These get checked for sanity */
     ccnt_t overhead_benchmarks[NUM_OVERHEAD_BENCHMARKS][RUNS];
     ccnt_t benchmarks[ARRAY_SIZE(benchmark_params)][RUNS];
+#ifdef CONFIG_GENERIC_COUNTER
+    /* Generic counter results, indexed by GENERIC_EVENTS. All events are measured
+     * in the same build by multiplexing chunks of counters across extra runs */
+    ccnt_t overhead_counters[NUM_OVERHEAD_BENCHMARKS][SEL4BENCH_NUM_GENERIC_EVENTS][RUNS];
+    ccnt_t counter_benchmarks[ARRAY_SIZE(benchmark_params)][SEL4BENCH_NUM_GENERIC_EVENTS][RUNS];
+#endif
+#ifdef CONFIG_APP_IPC_COLD_CACHE
+    /* results with the cache and TLB polluted before each IPC, indexed by pollution_sizes */
+    ccnt_t cold_benchmarks[ARRAY_SIZE(pollution_sizes)][ARRAY_SIZE(benchmark_params)][RUNS];
+#endif
+#ifdef CONFIG_APP_IPC_ADDRESS_SPACES
+    /* cycles of a Call, indexed by address_space_counts */
+    ccnt_t address_space_benchmarks[ARRAY_SIZE(address_space_counts)][RUNS];
+#endif
 } ipc_results_t;
 
 static inline bool
@@ -18,6 +18,44 @@
 #define N_IGNORED 10
 #define N_RUNS (100 + N_IGNORED)
 #define N_PRIOS ((seL4_MaxPrio + seL4_WordBits - 1) / seL4_WordBits)
+/* numbers of runnable threads in the ready queue benchmarks, powers of 2 from 1 */
+#define N_QUEUE_LENGTHS 9
+#define QUEUE_MAX_THREADS BIT(N_QUEUE_LENGTHS - 1)
+/* priorities of the threads switched between, above the runnable threads and below the benchmark */
+#define QUEUE_LOW_PRIO (seL4_MaxPrio - 2)
+#define QUEUE_HIGH_PRIO (seL4_MaxPrio - 1)
+#ifdef CONFIG_APP_SCHEDULER_PRIO_SWEEP
+#if CONFIG_APP_SCHEDULER_PRIO_SWEEP_STRIDE < 6 || CONFIG_APP_SCHEDULER_PRIO_SWEEP_STRIDE > 128
+#error "The priority sweep stride must be between 6 and 128"
+#endif
+/* priorities of the sweep grid, from above seL4_MinPrio to below the benchmark */
+#define N_SWEEP_PRIOS ((seL4_MaxPrio - 2) / CONFIG_APP_SCHEDULER_PRIO_SWEEP_STRIDE + 1)
+/* (low, high) pairs of the grid with high above low */
+#define N_SWEEP_PAIRS (N_SWEEP_PRIOS * (N_SWEEP_PRIOS - 1) / 2)
+#endif
+#ifdef CONFIG_KERNEL_RT
+/* priorities of the throttled thread and of the thread that runs while it is throttled */
+#define THROTTLE_PRIO (seL4_MaxPrio - 1)
+#define THROTTLE_OBSERVER_PRIO (seL4_MaxPrio - 2)
+/* a jump in the cycle counter larger than this means the throttled thread was not running */
+#define THROTTLE_GAP_CYCLES 10000
+#define N_SC_PARAMS 5
+
+/* scheduling context parameters, in microseconds */
+typedef struct sc_params {
+    uint64_t budget;
+    uint64_t period;
+    seL4_Word extra_refills;
+} sc_params_t;
+
+static const sc_params_t sc_params[N_SC_PARAMS] = {
+    { .budget = 100, .period = 1000, .extra_refills = 0 },
+    { .budget = 500, .period = 1000, .extra_refills = 0 },
+    { .budget = 1000, .period = 10000, .extra_refills = 0 },
+    { .budget = 100, .period = 1000, .extra_refills = 2 },
+    { .budget = 100, .period = 1000, .extra_refills = 4 },
+};
+#endif /* CONFIG_KERNEL_RT */
 
 typedef struct scheduler_results_t {
     ccnt_t thread_results[N_PRIOS][N_RUNS];
@@ -30,6 +68,22 @@ typedef struct scheduler_results_t {
     ccnt_t overhead_ccnt[N_RUNS];
     ccnt_t average_yield[N_RUNS][NUM_AVERAGE_EVENTS];
 
+    /* signal to higher prio thread with runnable threads at lower prios */
+    ccnt_t queue_signal[N_QUEUE_LENGTHS][N_RUNS];
+    /* yield from one thread to the next in round robin between runnable threads */
+    ccnt_t queue_yield[N_QUEUE_LENGTHS][N_RUNS];
+#ifdef CONFIG_APP_SCHEDULER_PRIO_SWEEP
+    /* signal to higher prio thread, indexed by sweep_pair of the low and high prio on the grid */
+    ccnt_t prio_sweep[N_SWEEP_PAIRS][N_RUNS];
+#endif
+#ifdef CONFIG_KERNEL_RT
+    /* seL4_SchedControl_Configure on an unbound scheduling context */
+    ccnt_t sched_ctrl_configure[N_SC_PARAMS][N_RUNS];
+    /* cycles a cpu bound thread ran past its budget before it was throttled */
+    ccnt_t throttle_overrun[N_SC_PARAMS][N_RUNS];
+    /* from the lower prio thread last running to the throttled thread running again */
+    ccnt_t replenish[N_SC_PARAMS][N_RUNS];
+#endif
 } scheduler_results_t;
 
 static inline uint8_t
@@ -47,4 +101,34 @@ gen_next_prio(int i)
     return seL4_MinPrio + 1 + (i * seL4_WordBits);
 }
 
+static inline int
+queue_length(int i)
+{
+    return BIT(i);
+}
+
+#ifdef CONFIG_APP_SCHEDULER_QUEUE
+/* priority of the nth runnable thread while measuring the switch triggered by seL4_Signal */
+static inline uint8_t
+queue_prio(int n)
+{
+    return seL4_MinPrio + 1 + (n % CONFIG_APP_SCHEDULER_QUEUE_PRIOS);
+}
+#endif /* CONFIG_APP_SCHEDULER_QUEUE */
+
+#ifdef CONFIG_APP_SCHEDULER_PRIO_SWEEP
+static inline uint8_t
+sweep_prio(int i)
+{
+    return seL4_MinPrio + 1 + i * CONFIG_APP_SCHEDULER_PRIO_SWEEP_STRIDE;
+}
+
+/* index of the pair of grid priorities low < high, in the order of walking low then high */
+static inline int
+sweep_pair(int low, int high)
+{
+    return low * N_SWEEP_PRIOS - low * (low + 1) / 2 + (high - low - 1);
+}
+#endif /* CONFIG_APP_SCHEDULER_PRIO_SWEEP */
+
 #endif /* __SELBENCH_SCHEDULER_H */
@@ -17,12 +17,60 @@
 
 #define N_IGNORED 10
 #define N_RUNS (100 + N_IGNORED)
+/* priorities of the signal grid, one in each word of the priority bitmap */
+#define N_SIGNAL_PRIOS ((seL4_MaxPrio + seL4_WordBits - 1) / seL4_WordBits)
+
+/* producers signal the fan-in notification with distinct badges, so at most one
+ * producer per badge bit */
+#define FANIN_MAX_PRODUCERS 16
+#define N_FANIN_PRODUCERS 5
+#define N_FANIN_DELAYS 4
+/* events the fan-in consumer receives for each producer count and delay */
+#define FANIN_EVENTS 1000
+
+static const int fanin_producers[N_FANIN_PRODUCERS] = { 1, 2, 4, 8, FANIN_MAX_PRODUCERS };
+/* cycles each producer spins for between signals */
+static const ccnt_t fanin_delays[N_FANIN_DELAYS] = { 0, 1000, 10000, 100000 };
+
+typedef struct fanin_result {
+    /* times the consumer returned from seL4_Wait */
+    ccnt_t wakeups;
+    /* badge bits seen by the consumer, ie. events delivered */
+    ccnt_t events;
+    /* signals sent by the producers, any more than events were coalesced away */
+    ccnt_t signals;
+    /* cycles taken to deliver the events */
+    ccnt_t cycles;
+    /* for each wakeup, from the signal of the longest waiting producer */
+    ccnt_t latency[FANIN_EVENTS];
+} fanin_result_t;
 
 typedef struct signal_results {
     ccnt_t lo_prio_results[N_RUNS];
     ccnt_t hi_prio_results[N_RUNS];
     ccnt_t overhead[N_RUNS];
     ccnt_t hi_prio_average[N_RUNS][NUM_AVERAGE_EVENTS];
+    ccnt_t ccnt_overhead[N_RUNS];
+
+    /* signal to a higher prio thread in another address space */
+    ccnt_t lo_prio_process_results[N_RUNS];
+    /* signal to a higher prio thread blocked receiving on an endpoint, with the
+     * notification bound to it */
+    ccnt_t bound_results[N_RUNS];
+    /* indexed by the prio of the signaller and of the waiter. If the waiter is higher
+     * prio, until it runs, otherwise until the signal returns */
+    ccnt_t grid_results[N_SIGNAL_PRIOS][N_SIGNAL_PRIOS][N_RUNS];
+    /* seL4_Poll with no signal pending, and with one pending */
+    ccnt_t poll_idle[N_RUNS];
+    ccnt_t poll_active[N_RUNS];
+    /* indexed by the number of producers and their delay */
+    fanin_result_t fanin[N_FANIN_PRODUCERS][N_FANIN_DELAYS];
 } signal_results_t;
 
+static inline uint8_t
+signal_prio(int i)
+{
+    return seL4_MinPrio + 1 + i * seL4_WordBits;
+}
+
 #endif /* __SELBENCH_SIGNAL_H */
@@ -22,6 +22,56 @@
 #define WARMUPS 2
 #define RUNS 5
 #define TESTS ARRAY_SIZE(smp_benchmark_params)
+/* round trips measured for each (ping core, pong core) pair of the latency matrix */
+#define MATRIX_WARMUPS 10
+#define MATRIX_SAMPLES 100
+/* round trips of a shared cache line measured for each pair of different cores */
+#define CACHE_LINE_WARMUPS 100
+#define CACHE_LINE_SAMPLES 100
+/* signal to wake up latencies measured for each case of the wake up benchmark */
+#define WAKE_WARMUPS 10
+#define WAKE_SAMPLES 100
+/* latencies are counted in a histogram of buckets growing logarithmically,
+ * with HIST_SUB_BUCKETS linear buckets for each power of two up to 2^32 cycles */
+#define HIST_SUB_BITS 3
+#define HIST_SUB_BUCKETS BIT(HIST_SUB_BITS)
+#define HIST_BUCKETS ((32 - HIST_SUB_BITS + 1) * HIST_SUB_BUCKETS)
+/* operations measured by the remote TCB operation benchmark */
+#define REMOTE_SAMPLES 100
+/* mean cycles a client of the server placement benchmark waits between requests,
+ * and the cycles of work the server does for each request */
+#define SERVER_CLIENT_DELAY 4000
+#define SERVER_WORK 1000
+
+/* operations run concurrently on every active core by the contention benchmark */
+typedef enum {
+    CONTENTION_NULL_SYSCALL,
+    CONTENTION_SIGNAL,
+    CONTENTION_YIELD,
+    CONTENTION_CALL,
+    NUM_CONTENTION_OPS
+} contention_op_t;
+
+static const char *const contention_op_names[NUM_CONTENTION_OPS] = {
+    [CONTENTION_NULL_SYSCALL] = "null syscall",
+    [CONTENTION_SIGNAL] = "seL4_Signal",
+    [CONTENTION_YIELD] = "seL4_Yield",
+    [CONTENTION_CALL] = "core-local seL4_Call",
+};
+
+/* placement of the servers of the server placement benchmark */
+typedef enum {
+    /* one server on core 0, called by a client on every active core */
+    SERVER_SHARED,
+    /* a server on every active core, called by a client on the same core */
+    SERVER_PER_CORE,
+    NUM_SERVER_MODES
+} server_mode_t;
+
+static const char *const server_mode_names[NUM_SERVER_MODES] = {
+    [SERVER_SHARED] = "shared server",
+    [SERVER_PER_CORE] = "server per core",
+};
 
 typedef struct benchmark_params {
     const char *name;
@@ -39,8 +89,179 @@ benchmark_params_t smp_benchmark_params[] = {
     { .name = "32000 cycles", .delay = 32000.0, },
 };
 
+/* the signaller always runs on core 0, the waiter either shares its core or runs on core 1.
+ * A busy waiter core has a lower priority thread spinning on it. */
+typedef struct wake_params {
+    const char *name;
+    const bool cross_core;
+    const bool busy;
+    const bool waiter_higher;
+} wake_params_t;
+
+static const
+wake_params_t smp_wake_params[] = {
+    { .name = "same core, idle, waiter higher",   .cross_core = false, .busy = false, .waiter_higher = true,  },
+    { .name = "same core, idle, waiter lower",    .cross_core = false, .busy = false, .waiter_higher = false, },
+    { .name = "same core, busy, waiter higher",   .cross_core = false, .busy = true,  .waiter_higher = true,  },
+    { .name = "same core, busy, waiter lower",    .cross_core = false, .busy = true,  .waiter_higher = false, },
+    { .name = "cross core, idle, waiter higher",  .cross_core = true,  .busy = false, .waiter_higher = true,  },
+    { .name = "cross core, idle, waiter lower",   .cross_core = true,  .busy = false, .waiter_higher = false, },
+    { .name = "cross core, busy, waiter higher",  .cross_core = true,  .busy = true,  .waiter_higher = true,  },
+    { .name = "cross core, busy, waiter lower",   .cross_core = true,  .busy = true,  .waiter_higher = false, },
+};
+
+#define WAKE_TESTS ARRAY_SIZE(smp_wake_params)
+
+/* operations invoked from core 0 on a thread on another core */
+typedef enum {
+    REMOTE_MIGRATE,
+    REMOTE_SUSPEND,
+    REMOTE_RESUME,
+    REMOTE_PRIO_RAISE,
+    REMOTE_PRIO_LOWER,
+    NUM_REMOTE_OPS
+} remote_op_t;
+
+typedef struct remote_params {
+    const char *name;
+    /* whether the time until the target runs again is measured */
+    const bool target_runs;
+} remote_params_t;
+
+static const
+remote_params_t smp_remote_params[NUM_REMOTE_OPS] = {
+#ifdef CONFIG_KERNEL_RT
+    [REMOTE_MIGRATE] = { .name = "SchedControl_Configure to another core", .target_runs = true, },
+#else
+    [REMOTE_MIGRATE] = { .name = "TCB_SetAffinity", .target_runs = true, },
+#endif
+    [REMOTE_SUSPEND] = { .name = "TCB_Suspend", .target_runs = false, },
+    [REMOTE_RESUME] = { .name = "TCB_Resume", .target_runs = true, },
+    [REMOTE_PRIO_RAISE] = { .name = "TCB_SetPriority (raise)", .target_runs = true, },
+    [REMOTE_PRIO_LOWER] = { .name = "TCB_SetPriority (lower)", .target_runs = false, },
+};
+
+static inline int
+hist_bucket(ccnt_t cycles)
+{
+    if (cycles < HIST_SUB_BUCKETS) {
+        return cycles;
+    }
+
+    int msb = 63 - __builtin_clzll((uint64_t) cycles);
+    int bucket = ((msb - HIST_SUB_BITS + 1) << HIST_SUB_BITS) |
+                 ((cycles >> (msb - HIST_SUB_BITS)) & (HIST_SUB_BUCKETS - 1));
+    return MIN(bucket, HIST_BUCKETS - 1);
+}
+
+static inline uint64_t
+hist_bucket_width(int bucket)
+{
+    if (bucket < HIST_SUB_BUCKETS) {
+        return 1;
+    }
+    return 1llu << ((bucket >> HIST_SUB_BITS) - 1);
+}
+
+static inline uint64_t
+hist_bucket_start(int bucket)
+{
+    if (bucket < HIST_SUB_BUCKETS) {
+        return bucket;
+    }
+    return (HIST_SUB_BUCKETS + (bucket & (HIST_SUB_BUCKETS - 1))) * hist_bucket_width(bucket);
+}
+
+/* results that do not depend on the number of cores */
 typedef struct smp_results {
-    ccnt_t benchmarks_result[TESTS][CONFIG_MAX_NUM_NODES][RUNS];
+    /* half of the signal/wait round trip between the signaller and the waiter */
+    ccnt_t wake_result[WAKE_TESTS][WAKE_SAMPLES];
+    /* duration of each remote operation as seen by the invoker */
+    ccnt_t remote_invoke[NUM_REMOTE_OPS][REMOTE_SAMPLES];
+    /* time from invoking a remote operation until the target is observed running */
+    ccnt_t remote_run[NUM_REMOTE_OPS][REMOTE_SAMPLES];
+    /* cache line size found at run time, in bytes */
+    uint32_t cache_line_size;
+    /* followed by the arrays below, dimensioned at run time by the number of cores */
+    uint64_t per_core_arrays[];
 } smp_results_t;
 
+/* arrays of results dimensioned by the number of cores n, in the order they follow
+ * smp_results_t. Active cores are indexed from 0, so n active cores have index n - 1. */
+typedef enum {
+    /* ccnt_t [TESTS][n][RUNS]: calls completed by all active cores */
+    SMP_THROUGHPUT,
+    /* ccnt_t [TESTS][n][n][RUNS]: calls completed by each active core */
+    SMP_THROUGHPUT_PER_CORE,
+    /* uint32_t [TESTS][n][HIST_BUCKETS]: histogram of call latencies of all active cores */
+    SMP_LATENCY_HISTOGRAM,
+    /* ccnt_t [NUM_CONTENTION_OPS][n][n][RUNS]: operations completed by each active core */
+    SMP_CONTENTION_OPS,
+    /* uint32_t [NUM_CONTENTION_OPS][n][HIST_BUCKETS]: histogram of operation latencies of all active cores */
+    SMP_CONTENTION_HISTOGRAM,
+    /* ccnt_t [n][n][MATRIX_SAMPLES]: round trip latency with ping on the first core and pong on the second */
+    SMP_MATRIX,
+    /* ccnt_t [n][n][CACHE_LINE_SAMPLES]: round trip of a shared cache line between two different cores */
+    SMP_CACHE_LINE,
+    /* ccnt_t [NUM_SERVER_MODES][n][RUNS]: requests served for the clients of all active cores */
+    SMP_SERVER_THROUGHPUT,
+    /* uint32_t [NUM_SERVER_MODES][n][HIST_BUCKETS]: histogram of request latencies of all active cores */
+    SMP_SERVER_HISTOGRAM,
+    NUM_SMP_RESULT_ARRAYS
+} smp_result_array_t;
+
+static inline size_t
+smp_result_array_size(int nr_cores, smp_result_array_t array)
+{
+    size_t n = nr_cores;
+
+    switch (array) {
+    case SMP_THROUGHPUT:
+        return TESTS * n * RUNS * sizeof(ccnt_t);
+    case SMP_THROUGHPUT_PER_CORE:
+        return TESTS * n * n * RUNS * sizeof(ccnt_t);
+    case SMP_LATENCY_HISTOGRAM:
+        return TESTS * n * HIST_BUCKETS * sizeof(uint32_t);
+    case SMP_CONTENTION_OPS:
+        return NUM_CONTENTION_OPS * n * n * RUNS * sizeof(ccnt_t);
+    case SMP_CONTENTION_HISTOGRAM:
+        return NUM_CONTENTION_OPS * n * HIST_BUCKETS * sizeof(uint32_t);
+    case SMP_MATRIX:
+        return n * n * MATRIX_SAMPLES * sizeof(ccnt_t);
+    case SMP_CACHE_LINE:
+        return n * n * CACHE_LINE_SAMPLES * sizeof(ccnt_t);
+    case SMP_SERVER_THROUGHPUT:
+        return NUM_SERVER_MODES * n * RUNS * sizeof(ccnt_t);
+    case SMP_SERVER_HISTOGRAM:
+        return NUM_SERVER_MODES * n * HIST_BUCKETS * sizeof(uint32_t);
+    default:
+        return 0;
+    }
+}
+
+static inline size_t
+smp_result_array_offset(int nr_cores, smp_result_array_t array)
+{
+    size_t offset = sizeof(smp_results_t);
+
+    for (smp_result_array_t i = 0; i < array; i++) {
+        offset += ROUND_UP(smp_result_array_size(nr_cores, i), sizeof(uint64_t));
+    }
+    return offset;
+}
+
+/* size in bytes of the results of a run on nr_cores cores */
+static inline size_t
+smp_results_size(int nr_cores)
+{
+    return smp_result_array_offset(nr_cores, NUM_SMP_RESULT_ARRAYS);
+}
+
+/* returns the start of an array of results, to be cast to the type documented above */
+static inline void *
+smp_result_array(smp_results_t *results, int nr_cores, smp_result_array_t array)
+{
+    return (char *) results + smp_result_array_offset(nr_cores, array);
+}
+
 #endif /* __SELBENCH_SMP_H */
@@ -0,0 +1,54 @@
+/*
+ * Copyright 2017, Data61
+ * Commonwealth Scientific and Industrial Research Organisation (CSIRO)
+ * ABN 41 687 119 230.
+ *
+ * This software may be distributed and modified according to the terms of
+ * the BSD 2-Clause license. Note that NO WARRANTY is provided.
+ * See "LICENSE_BSD2.txt" for details.
+ *
+ * @TAG(DATA61_BSD)
+ */
+#ifndef __SELBENCH_TASKSET_H
+#define __SELBENCH_TASKSET_H
+
+#include <autoconf.h>
+#include <sel4bench/sel4bench.h>
+#include <utils/util.h>
+
+#ifdef CONFIG_APP_TASKSET_TASKS
+#define TASKSET_TASKS CONFIG_APP_TASKSET_TASKS
+#else
+#define TASKSET_TASKS {10000, 3000, 2000, 100}, {20000, 6000, 4000, 99}, {50000, 12000, 8000, 98}
+#endif
+
+/* jobs recorded for each task, any released after this are run but not recorded */
+#define TASKSET_MAX_JOBS 1000
+/* a jump in the cycle counter larger than this means a job was preempted, and is
+ * not counted as execution */
+#define TASKSET_GAP_CYCLES 1000
+
+/* times in microseconds */
+typedef struct taskset_task {
+    uint64_t period;
+    uint64_t budget;
+    /* execution time each job spins for */
+    uint64_t spin;
+    uint8_t prio;
+} taskset_task_t;
+
+static const taskset_task_t taskset_tasks[] = { TASKSET_TASKS };
+#define N_TASKS ARRAY_SIZE(taskset_tasks)
+
+typedef struct taskset_results {
+    /* cycles per microsecond, measured against the timer */
+    uint64_t cycles_per_us;
+    /* jobs recorded for each task */
+    ccnt_t jobs[N_TASKS];
+    /* jobs that completed after their implicit deadline */
+    ccnt_t missed[N_TASKS];
+    /* cycles from each job being released to it completing */
+    ccnt_t response[N_TASKS][TASKSET_MAX_JOBS];
+} taskset_results_t;
+
+#endif /* __SELBENCH_TASKSET_H */
@@ -0,0 +1,52 @@
+/*
+ * Copyright 2017, Data61
+ * Commonwealth Scientific and Industrial Research Organisation (CSIRO)
+ * ABN 41 687 119 230.
+ *
+ * This software may be distributed and modified according to the terms of
+ * the BSD 2-Clause license. Note that NO WARRANTY is provided.
+ * See "LICENSE_BSD2.txt" for details.
+ *
+ * @TAG(DATA61_BSD)
+ */
+#ifndef __SELBENCH_WAKEUP_H
+#define __SELBENCH_WAKEUP_H
+
+#include <sel4bench/sel4bench.h>
+#include <utils/time.h>
+#include "benchmark.h"
+
+#define N_IGNORED 10
+#define N_RUNS (100 + N_IGNORED)
+
+/* the periodic thread is woken every period, and how late it wakes is recorded in ns */
+#define WAKEUP_PERIOD_NS NS_IN_MS
+#define WAKEUP_WARMUPS 10
+#define WAKEUP_SAMPLES 1000
+
+/* load run below the periodic thread while it is measured */
+typedef enum {
+    WAKEUP_LOAD_NONE,
+    /* a thread spinning */
+    WAKEUP_LOAD_SPIN,
+    /* a pair of threads calling each other */
+    WAKEUP_LOAD_IPC,
+    NUM_WAKEUP_LOADS
+} wakeup_load_t;
+
+static const char *const wakeup_load_names[NUM_WAKEUP_LOADS] = {
+    [WAKEUP_LOAD_NONE] = "none",
+    [WAKEUP_LOAD_SPIN] = "CPU spinner",
+    [WAKEUP_LOAD_IPC] = "IPC storm",
+};
+
+typedef struct wakeup_results {
+    /* ns taken to read the time, which is included in every latency */
+    ccnt_t overheads[N_RUNS];
+    /* ns between each programmed wake up and the periodic thread running */
+    ccnt_t latency[NUM_WAKEUP_LOADS][WAKEUP_SAMPLES];
+    /* periods skipped as they had started by the time the next timeout was armed */
+    ccnt_t missed[NUM_WAKEUP_LOADS];
+} wakeup_results_t;
+
+#endif /* __SELBENCH_WAKEUP_H */
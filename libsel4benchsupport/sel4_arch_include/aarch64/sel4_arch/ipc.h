@@ -79,6 +79,30 @@
         : "r"(scno), "r" (ro_copy) \
     ); \
 } while(0)
+
+/* NBSendRecv takes the destination in x8, NBSendWait takes it in the reply register */
+#define DO_NBSEND_RECV(dest, tag, src, ro, swi) do { \
+    register seL4_Word src_copy asm("x0") = (seL4_Word)src; \
+    register seL4_MessageInfo_t info asm("x1") = tag; \
+    register seL4_Word scno asm("x7") = seL4_SysNBSendRecv; \
+    register seL4_Word ro_copy asm("x6") = ro; \
+    register seL4_Word dest_copy asm("x8") = dest; \
+    asm volatile(NOPS swi NOPS \
+        : "+r"(src_copy), "+r"(info) \
+        : "r"(scno), "r" (ro_copy), "r" (dest_copy) \
+    ); \
+} while(0)
+
+#define DO_NBSEND_WAIT(dest, tag, src, swi) do { \
+    register seL4_Word src_copy asm("x0") = (seL4_Word)src; \
+    register seL4_MessageInfo_t info asm("x1") = tag; \
+    register seL4_Word scno asm("x7") = seL4_SysNBSendWait; \
+    register seL4_Word dest_copy asm("x6") = dest; \
+    asm volatile(NOPS swi NOPS \
+        : "+r"(src_copy), "+r"(info) \
+        : "r"(scno), "r" (dest_copy) \
+    ); \
+} while(0)
 #else
 #define DO_REPLY_RECV_10(ep, tag, ro, swi) do { \
     register seL4_Word src asm("x0") = (seL4_Word)ep; \
@@ -125,3 +149,10 @@
 #define DO_NOP_REPLY_RECV_10(ep, tag, ro) DO_REPLY_RECV_10(ep, tag, ro, "nop")
 #define DO_REAL_RECV(ep, ro) DO_RECV(ep, ro, "svc #0")
 #define DO_NOP_RECV(ep, ro) DO_RECV(ep, ro, "nop")
+
+#ifdef CONFIG_KERNEL_RT
+#define DO_REAL_NBSEND_RECV(dest, tag, src, ro) DO_NBSEND_RECV(dest, tag, src, ro, "svc #0")
+#define DO_NOP_NBSEND_RECV(dest, tag, src, ro) DO_NBSEND_RECV(dest, tag, src, ro, "nop")
+#define DO_REAL_NBSEND_WAIT(dest, tag, src) DO_NBSEND_WAIT(dest, tag, src, "svc #0")
+#define DO_NOP_NBSEND_WAIT(dest, tag, src) DO_NBSEND_WAIT(dest, tag, src, "nop")
+#endif /* CONFIG_KERNEL_RT */
@@ -214,3 +214,12 @@
 #define DO_NOP_REPLY_RECV_10(ep, tag, ro) DO_REPLY_RECV_10(ep, tag, ro, ".byte 0x66\n.byte 0x90")
 #define DO_REAL_RECV(ep, ro) DO_RECV(ep, ro, "sysenter")
 #define DO_NOP_RECV(ep, ro) DO_RECV(ep, ro, ".byte 0x66\n.byte 0x90")
+
+#ifdef CONFIG_KERNEL_RT
+/* ia32 is short on registers for the non-blocking variants, so use the libsel4 calls.
+ * These can't be turned into nops, so only the overhead of reading the counter is measured. */
+#define DO_REAL_NBSEND_RECV(dest, tag, src, ro) seL4_NBSendRecv(dest, tag, src, NULL, ro)
+#define DO_NOP_NBSEND_RECV(dest, tag, src, ro) do { (void) (tag); } while (0)
+#define DO_REAL_NBSEND_WAIT(dest, tag, src) seL4_NBSendWait(dest, tag, src, NULL)
+#define DO_NOP_NBSEND_WAIT(dest, tag, src) do { (void) (tag); } while (0)
+#endif /* CONFIG_KERNEL_RT */
@@ -118,6 +118,45 @@
             :  "rcx", "rbx","r11" \
             ); \
 } while (0)
+
+/* NBSendRecv takes the destination in r13, NBSendWait takes it in the reply register */
+#define DO_NBSEND_RECV(dest, tag, src, ro, sys) do { \
+    uint64_t src_copy = src; \
+    register seL4_Word ro_copy asm("r12") = ro;\
+    register seL4_Word dest_copy asm("r13") = dest;\
+    asm volatile( \
+            "movq   %%rsp, %%rbx \n" \
+            sys "\n" \
+            "movq  %%rbx, %%rsp \n" \
+            : \
+            "+S" (tag), \
+            "+D" (src_copy) \
+            : \
+            "d"((seL4_Word)seL4_SysNBSendRecv), \
+            "r" (ro_copy), \
+            "r" (dest_copy) \
+            : \
+            "rcx", "rbx","r11" \
+            ); \
+} while (0)
+
+#define DO_NBSEND_WAIT(dest, tag, src, sys) do { \
+    uint64_t src_copy = src; \
+    register seL4_Word dest_copy asm("r12") = dest;\
+    asm volatile( \
+            "movq   %%rsp, %%rbx \n" \
+            sys "\n" \
+            "movq  %%rbx, %%rsp \n" \
+            : \
+            "+S" (tag), \
+            "+D" (src_copy) \
+            : \
+            "d"((seL4_Word)seL4_SysNBSendWait), \
+            "r" (dest_copy) \
+            : \
+            "rcx", "rbx","r11" \
+            ); \
+} while (0)
 #else
 #define DO_REPLY_RECV(ep, tag, ro, sys) do { \
     uint64_t ep_copy = ep; \
@@ -207,6 +246,13 @@
 #define DO_REAL_RECV(ep, ro) DO_RECV(ep, ro, "syscall")
 #define DO_NOP_RECV(ep, ro) DO_RECV(ep, ro, ".byte 0x66\n.byte 0x90")
 
+#ifdef CONFIG_KERNEL_RT
+#define DO_REAL_NBSEND_RECV(dest, tag, src, ro) DO_NBSEND_RECV(dest, tag, src, ro, "syscall")
+#define DO_NOP_NBSEND_RECV(dest, tag, src, ro) DO_NBSEND_RECV(dest, tag, src, ro, ".byte 0x66\n.byte 0x90")
+#define DO_REAL_NBSEND_WAIT(dest, tag, src) DO_NBSEND_WAIT(dest, tag, src, "syscall")
+#define DO_NOP_NBSEND_WAIT(dest, tag, src) DO_NBSEND_WAIT(dest, tag, src, ".byte 0x66\n.byte 0x90")
+#endif /* CONFIG_KERNEL_RT */
+
 #else
 #error Only support benchmarking with syscall as sysenter is known to be slower
 #endif /* CONFIG_SYSCALL */
@@ -23,6 +23,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <vka/capops.h>
 
 #include <benchmark.h>
 
@@ -240,6 +241,20 @@ benchmark_configure_thread(env_t *env, seL4_CPtr fault_ep, uint8_t prio, char *n
     NAME_THREAD(thread->tcb.cptr, name);
 }
 
+seL4_CPtr
+benchmark_mint_badged_cap(env_t *env, seL4_CPtr cap, seL4_Word badge)
+{
+    cspacepath_t src, dest;
+
+    vka_cspace_make_path(&env->slab_vka, cap, &src);
+    int error = vka_cspace_alloc_path(&env->slab_vka, &dest);
+    ZF_LOGF_IF(error, "Failed to allocate slot for badged cap");
+    error = vka_cnode_mint(&dest, &src, seL4_AllRights, badge);
+    ZF_LOGF_IF(error, "Failed to mint badged cap");
+
+    return dest.capPtr;
+}
+
 void
 benchmark_wait_children(seL4_CPtr ep, char *name, int num_children)
 {
@@ -431,31 +446,51 @@ benchmark_get_env(int argc, char **argv, size_t results_size, size_t object_freq
 }
 
 void
-send_result(seL4_CPtr ep, ccnt_t result)
+send_results(seL4_CPtr ep, size_t n, ccnt_t results[n])
 {
     int length = sizeof(ccnt_t) / sizeof(seL4_Word);
     unsigned int shift = length > 1u ? seL4_WordBits : 0;
-    for (int i = length - 1; i >= 0; i--) {
-        seL4_SetMR(i, (seL4_Word) result);
-        result = result >> shift;
+    for (size_t r = 0; r < n; r++) {
+        ccnt_t result = results[r];
+        for (int i = length - 1; i >= 0; i--) {
+            seL4_SetMR(r * length + i, (seL4_Word) result);
+            result = result >> shift;
+        }
     }
 
-    seL4_MessageInfo_t tag = seL4_MessageInfo_new(0, 0, 0, (seL4_Uint32)length);
+    seL4_MessageInfo_t tag = seL4_MessageInfo_new(0, 0, 0, (seL4_Uint32) (n * length));
     seL4_Send(ep, tag);
 }
 
-ccnt_t
-get_result(seL4_CPtr ep)
+void
+get_results(seL4_CPtr ep, size_t n, ccnt_t results[n])
 {
-    ccnt_t result = 0;
-    seL4_MessageInfo_t tag = api_wait(ep, NULL);
-    int length = seL4_MessageInfo_get_length(tag);
+    int length = sizeof(ccnt_t) / sizeof(seL4_Word);
     unsigned int shift = length > 1u ? seL4_WordBits : 0;
-
-    for (int i = 0; i < length; i++) {
-        result = result << shift;
-        result += seL4_GetMR(i);
+    seL4_MessageInfo_t tag = api_wait(ep, NULL);
+    ZF_LOGF_IF(seL4_MessageInfo_get_length(tag) != n * length,
+               "Expected %zu results, got %zu words", n, (size_t) seL4_MessageInfo_get_length(tag));
+
+    for (size_t r = 0; r < n; r++) {
+        ccnt_t result = 0;
+        for (int i = 0; i < length; i++) {
+            result = result << shift;
+            result += seL4_GetMR(r * length + i);
+        }
+        results[r] = result;
     }
+}
 
+void
+send_result(seL4_CPtr ep, ccnt_t result)
+{
+    send_results(ep, 1, &result);
+}
+
+ccnt_t
+get_result(seL4_CPtr ep)
+{
+    ccnt_t result = 0;
+    get_results(ep, 1, &result);
     return result;
 }